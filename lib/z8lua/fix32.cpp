@@ -0,0 +1,327 @@
+//
+//  ZEPTO-8 — Fantasy console emulator
+//
+//  Copyright © 2016–2024 Sam Hocevar <sam@hocevar.net>
+//
+//  This program is free software. It comes without any warranty, to
+//  the extent permitted by applicable law. You can redistribute it
+//  and/or modify it under the terms of the Do What the Fuck You Want
+//  to Public License, Version 2, as published by the WTFPL Task Force.
+//  See http://www.wtfpl.net/ for more details.
+//
+
+#include "fix32.h"
+
+#include "trigtables.h"
+
+namespace z8
+{
+
+fix32 fix32::sin(fix32 x)
+{
+    // Reduce angle to 0x0 … 0x0.3fff, with the following PICO-8 rules:
+    //  - sin(x) = -sin(x + 0.5)
+    //  - sin(x) equals sin(~x) rather than sin(-x)
+    //  - the last two bits are rounded
+    // We use a lookup table of sin(x)-4x generated by PICO-8 to ensure
+    // that we get the exact same results.
+    int32_t a = ((x.m_bits & 0x4000 ? ~x : x).m_bits & 0x3fff) + 2;
+    fix32 ret = frombits((a >> 2 << 4) + sintable[a >> 2]);
+    return x.m_bits & 0x8000 ? ret : -ret;
+}
+
+fix32 fix32::cos(fix32 x)
+{
+    return sin(x - frombits(0x4000));
+}
+
+fix32 fix32::atan2(fix32 x, fix32 y)
+{
+    int32_t bits = 0x4000;
+    if (x)
+    {
+        // Take |y| and |x| as unsigned to emulate PICO-8’s behaviour with
+        // e.g. atan2(0x8000, 0x8000.0001), then index the table by
+        // min(q, 1/q) where q = |y|/|x|.
+        uint32_t q;
+        if (!udiv16(uabs(y.m_bits), uabs(x.m_bits), q))
+            bits -= atantable[0]; // q >= 2^32, so 1/q rounds to 0
+        else if (q > 0x1'0000)
+        {
+            // 2^32 / q without a 64-bit divide
+            uint32_t inv = 0xffff'ffffu / q;
+            if (0xffff'ffffu - inv * q == q - 1)
+                ++inv;
+            bits -= atantable[inv >> 5];
+        }
+        else
+            bits = atantable[q >> 5];
+    }
+    if (x.m_bits < 0) bits = 0x8000 - bits;
+    if (y.m_bits > 0) bits = -bits & 0xffff;
+    // Emulate a bug in PICO-8 with e.g. atan2(1, 0x8000)
+    if (x && y.m_bits == int32_t(0x80000000)) bits = -bits & 0xffff;
+    return frombits(bits);
+}
+
+fix32 fix32::sqrt(fix32 x)
+{
+    // Square root by abacus algorithm, Martin Guy @ UKC, June 1985.
+    // From a book on programming abaci by Mr C. Woo.
+    // Observing a PICO-8 JavaScript export shows the same algorithm.
+    // The radicand is bits << 16, fed in two bits at a time; the remainder
+    // never exceeds 2 * root + 1, so 32-bit arithmetic is enough.
+    if (x.m_bits <= 0)
+        return frombits(0);
+    uint32_t src = uint32_t(x.m_bits), rem = 0, root = 0;
+    for (int i = 0; i < 24; ++i)
+    {
+        rem = (rem << 2) | (src >> 30);
+        src <<= 2;
+        root <<= 1;
+        uint32_t trial = (root << 1) | 1;
+        if (rem >= trial)
+        {
+            rem -= trial;
+            root |= 1;
+        }
+    }
+    return frombits(int32_t(root));
+}
+
+static char *putuint(char *p, uint32_t x)
+{
+    char digits[10];
+    int n = 0;
+    do
+    {
+        digits[n++] = char('0' + x % 10);
+        x /= 10;
+    } while (x);
+    while (n)
+        *p++ = digits[--n];
+    return p;
+}
+
+static char *puthex(char *p, uint32_t x, int count)
+{
+    while (count--)
+        *p++ = "0123456789abcdef"[(x >> (4 * count)) & 0xf];
+    return p;
+}
+
+int fix32::tostr(char *s, fix32 x, int flags)
+{
+    char *p = s;
+    switch (flags & 0x3)
+    {
+    case 0x1:
+        *p++ = '0';
+        *p++ = 'x';
+        p = puthex(p, uint32_t(x.m_bits) >> 16, 4);
+        *p++ = '.';
+        p = puthex(p, uint32_t(x.m_bits), 4);
+        break;
+    case 0x2:
+        if (x.m_bits < 0)
+            *p++ = '-';
+        p = putuint(p, uabs(x.m_bits));
+        break;
+    case 0x3:
+        *p++ = '0';
+        *p++ = 'x';
+        p = puthex(p, uint32_t(x.m_bits), 8);
+        break;
+    default:
+    {
+        // The fraction is rounded to four places on its exact value, ties
+        // to even, which is what printf does; negative numbers keep their
+        // sign even when they round to zero ("-0").
+        uint32_t u = uabs(x.m_bits);
+        uint32_t ipart = u >> 16;
+        uint32_t scaled = (u & 0xffff) * 10000;
+        uint32_t frac = scaled >> 16, rem = scaled & 0xffff;
+        if (rem > 0x8000 || (rem == 0x8000 && (frac & 1)))
+            ++frac;
+        if (frac == 10000)
+        {
+            ++ipart;
+            frac = 0;
+        }
+
+        if (x.m_bits < 0)
+            *p++ = '-';
+        p = putuint(p, ipart);
+        if (frac)
+        {
+            *p++ = '.';
+            for (uint32_t div = 1000; frac; div /= 10)
+            {
+                *p++ = char('0' + frac / div);
+                frac %= div;
+            }
+        }
+        break;
+    }
+    }
+    *p = '\0';
+    return int(p - s);
+}
+
+static inline bool isdigit_c(char c) { return c >= '0' && c <= '9'; }
+static inline bool isspace_c(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+fix32 fix32::fromstr(const char *s, char **end)
+{
+    // Significant digits go to a buffer with the position of the decimal
+    // point, so the exponent only moves the point. Digits past the buffer
+    // are below 2^-16 once there are more than five integer digits, or
+    // only scale the integer part further.
+    const int MAX_DIGITS = 40;
+    char digits[MAX_DIGITS];
+    int count = 0, point = 0;
+    bool seen = false, dropped = false; // dropped: a non-zero digit past the buffer
+
+    const char *p = s;
+    *end = const_cast<char *>(s);
+    while (isspace_c(*p))
+        ++p;
+    bool neg = *p == '-';
+    if (*p == '-' || *p == '+')
+        ++p;
+
+    for (; isdigit_c(*p); ++p)
+    {
+        seen = true;
+        if (count == 0 && *p == '0')
+            continue;
+        if (count < MAX_DIGITS)
+            digits[count++] = *p;
+        else
+            dropped |= *p != '0';
+        ++point;
+    }
+    if (*p == '.')
+    {
+        for (++p; isdigit_c(*p); ++p)
+        {
+            seen = true;
+            if (count == 0 && *p == '0')
+                --point;
+            else if (count < MAX_DIGITS)
+                digits[count++] = *p;
+            else
+                dropped |= *p != '0';
+        }
+    }
+    if (!seen)
+        return frombits(0);
+
+    if (*p == 'e' || *p == 'E')
+    {
+        const char *q = p + 1;
+        bool eneg = *q == '-';
+        if (*q == '-' || *q == '+')
+            ++q;
+        if (isdigit_c(*q))
+        {
+            int exp = 0;
+            for (; isdigit_c(*q); ++q)
+                if (exp < 10000)
+                    exp = exp * 10 + (*q - '0');
+            point += eneg ? -exp : exp;
+            p = q;
+        }
+    }
+    *end = const_cast<char *>(p);
+
+    // The double cast was only defined below 2^47; past that x86 gives 0
+    if (point > 15)
+        return frombits(0);
+    uint64_t ipart = 0;
+    for (int i = 0; i < point; ++i)
+        ipart = ipart * 10 + uint64_t(i < count ? digits[i] - '0' : 0);
+    if (ipart >> 47)
+        return frombits(0); // rounding only goes up from here
+
+    // Fraction bits 16 at a time: multiply the remaining decimal digits by
+    // 2^16 and take what carries out of the first one. Below 10^-5 there is
+    // nothing left to find.
+    uint32_t frac = 0;
+    uint64_t guard = 0; // the 48 bits after frac
+    bool sticky = dropped; // anything non-zero past guard
+    if (point > -5 && count > point)
+    {
+        int n = count - point;
+        uint8_t f[MAX_DIGITS + 5];
+        for (int i = 0; i < n; ++i)
+        {
+            int k = point + i;
+            f[i] = uint8_t(k < 0 ? 0 : digits[k] - '0');
+        }
+        for (int round = 0; round < 4; ++round)
+        {
+            uint32_t carry = 0;
+            for (int i = n; i--; )
+            {
+                uint32_t d = f[i] * 65536u + carry;
+                carry = d / 10;
+                f[i] = uint8_t(d - carry * 10);
+            }
+            if (round == 0)
+                frac = carry;
+            else
+                guard = (guard << 16) | carry;
+        }
+        for (int i = 0; i < n; ++i)
+            sticky |= f[i] != 0;
+    }
+
+    // strtod() rounded to the nearest double before the cast truncated, so
+    // a value within half a double ulp below the next 2^-16 step landed on
+    // it. With a 53-bit mantissa that is when the first 37 - e guard bits
+    // are all ones, e being the exponent of the value's leading bit.
+    int e = 0;
+    if (ipart)
+    {
+        for (uint64_t x = ipart >> 1; x; x >>= 1)
+            ++e;
+    }
+    else
+    {
+        e = -65;
+        for (uint64_t x = (uint64_t(frac) << 48) | guard; x; x >>= 1)
+            ++e;
+    }
+    int g = 37 - e;
+    if (g <= 0)
+    {
+        // From 2^37 up the double could not even hold the 16 fraction bits:
+        // it kept 52 - e of them, rounded to nearest even on everything
+        // below, and the cast then had nothing left to truncate.
+        int r = 1 - g;
+        uint64_t v = (ipart << 16) | frac;
+        uint64_t rem = v & ((uint64_t(1) << r) - 1), half = uint64_t(1) << (r - 1);
+        v -= rem;
+        if (rem > half || (rem == half && (guard || sticky || (v >> r & 1))))
+            v += uint64_t(1) << r;
+        if (v >> 63)
+            return frombits(0); // rounded up to 2^47
+        uint32_t bits = uint32_t(v);
+        return frombits(int32_t(neg ? 0u - bits : bits));
+    }
+    if (g <= 48)
+    {
+        uint64_t mask = ((uint64_t(1) << g) - 1) << (48 - g);
+        if ((guard & mask) == mask && ++frac == 0x10000)
+        {
+            frac = 0;
+            ++ipart;
+        }
+    }
+
+    uint32_t bits = (uint32_t(ipart) << 16) | frac;
+    return frombits(int32_t(neg ? 0u - bits : bits));
+}
+
+}
@@ -143,10 +143,9 @@ struct fix32
 
         if (x.m_bits)
         {
-            using std::abs;
-            int64_t result = int64_t(m_bits) * 0x1'0000 / x.m_bits;
-            if (abs(result) <= 0x7fff'ffffu)
-                return frombits(int32_t(result));
+            uint32_t q;
+            if (udiv16(uabs(m_bits), uabs(x.m_bits), q) && q <= 0x7fff'ffffu)
+                return frombits((m_bits ^ x.m_bits) < 0 ? -int32_t(q) : int32_t(q));
         }
 
         // Return 0x8000.0001 (not 0x8000.0000) for -Inf, just like PICO-8
@@ -219,6 +218,26 @@ struct fix32
         return fix32(std::pow(double(x), double(y)));
     }
 
+    // PICO-8 math functions (fix32.cpp), bit-exact and without any floating
+    // point: sin/cos/atan2 read the tables PICO-8 itself was sampled into,
+    // sqrt is the digit-by-digit root PICO-8 uses.
+    static fix32 sin(fix32 x);
+    static fix32 cos(fix32 x);
+    static fix32 atan2(fix32 x, fix32 y);
+    static fix32 sqrt(fix32 x);
+
+    // Text conversions (fix32.cpp), integer-only and locale-independent.
+    // tostr() writes the PICO-8 tostr(x, flags) forms and returns the
+    // length, at most 11 plus the terminator:
+    //   0: what "%1.4f" prints with trailing zeros trimmed, as Lua does
+    //   1: "0x1234.abcd"   2: the bits as a signed integer   3: "0x1234abcd"
+    // fromstr() reads a decimal number the way strtod() followed by the
+    // double cast did (rounded to 53 bits, then truncated, low 16 integer
+    // bits kept), without the double. *end points past the number, or at
+    // s when there is none.
+    static int tostr(char *s, fix32 x, int flags = 0);
+    static fix32 fromstr(const char *s, char **end);
+
     static inline fix32 lshr(fix32 x, int y)
     {
         // If y is negative, use << instead.
@@ -238,6 +257,49 @@ struct fix32
     }
 
 private:
+    static inline uint32_t uabs(int32_t x) { return x < 0 ? 0u - uint32_t(x) : uint32_t(x); }
+
+    // q = (n << 16) / d, false when that does not fit in 32 bits. 64-bit
+    // hosts divide natively; on the 32-bit ARM targets a 64-bit divide is
+    // a slow libgcc call (the GBA and 3DS CPUs lack even a 32-bit divide),
+    // so there it is split into 32-bit steps and powers of two are shifts.
+    static inline bool udiv16(uint32_t n, uint32_t d, uint32_t &q)
+    {
+#if defined(__x86_64__) || defined(__aarch64__) || !defined(__GNUC__)
+        uint64_t r = (uint64_t(n) << 16) / d;
+        q = uint32_t(r);
+        return (r >> 32) == 0;
+#else
+        if ((d & (d - 1)) == 0)
+        {
+            int s = __builtin_ctz(d);
+            if (s >= 16) { q = n >> (s - 16); return true; }
+            if (n >> (16 + s)) return false;
+            q = n << (16 - s);
+            return true;
+        }
+        uint32_t hi = n / d, r = n % d;
+        if (hi >> 16) return false;
+        uint32_t lo;
+        if (d <= 0xffff)
+            lo = (r << 16) / d;
+        else
+        {
+            // r < d, so one quotient bit per step; the carry keeps r exact
+            lo = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                uint32_t carry = r >> 31;
+                r <<= 1;
+                lo <<= 1;
+                if (carry || r >= d) { r -= d; lo |= 1; }
+            }
+        }
+        q = (hi << 16) | lo;
+        return true;
+#endif
+    }
+
     int32_t m_bits;
 };
 
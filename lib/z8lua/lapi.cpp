@@ -390,6 +390,32 @@ LUA_API lua_Unsigned lua_tounsignedx (lua_State *L, int idx, int *isnum) {
 }
 
 
+/*
+** z8lua: raw fix32 bits of an argument, for the PICO-8 API. Returns 0
+** for nil or none and leaves *bits alone so the caller keeps its default;
+** otherwise stores the number (booleans are 0/1, anything that does not
+** convert is 0) and returns 1.
+*/
+static int fix32bits (const TValue *o, int32_t *bits) {
+  if (ttisnumber(o)) {
+    *bits = nvalue(o).bits();
+    return 1;
+  }
+  if (ttisnil(o)) return 0;
+  if (ttisboolean(o)) {
+    *bits = bvalue(o) ? 0x10000 : 0;
+    return 1;
+  }
+  TValue n;
+  *bits = tonumber(o, &n) ? nvalue(o).bits() : 0;
+  return 1;
+}
+
+LUA_API int lua_tofix32bits (lua_State *L, int idx, int32_t *bits) {
+  return fix32bits(index2addr(L, idx), bits);
+}
+
+
 LUA_API int lua_toboolean (lua_State *L, int idx) {
   const TValue *o = index2addr(L, idx);
   return !l_isfalse(o);
@@ -520,6 +546,22 @@ LUA_API const char *lua_pushlstring (lua_State *L, const char *s, size_t len) {
 }
 
 
+/*
+** z8lua: pushes the 'l' bytes at offset 'i' of the string at 'idx'; short
+** results reuse recent substrings (see luaS_newsub)
+*/
+LUA_API void lua_pushsubstring (lua_State *L, int idx, size_t i, size_t l) {
+  TString *src;
+  lua_lock(L);
+  luaC_checkGC(L);
+  src = rawtsvalue(index2addr(L, idx));
+  api_check(L, i + l <= src->tsv.len, "substring out of range");
+  setsvalue2s(L, L->top, luaS_newsub(L, src, i, l));
+  api_incr_top(L);
+  lua_unlock(L);
+}
+
+
 LUA_API const char *lua_pushstring (lua_State *L, const char *s) {
   if (s == NULL) {
     lua_pushnil(L);
@@ -667,6 +709,36 @@ LUA_API void lua_rawgeti (lua_State *L, int idx, int n) {
 }
 
 
+/*
+** z8lua: t[n .. n+count-1] as fix32 bits without touching the stack, for
+** the batched draw list. Same conversions as lua_tofix32bits; bit i of
+** the result is set when t[n+i] was present (count <= 32).
+*/
+LUA_API unsigned lua_rawgetfix32s (lua_State *L, int idx, int n, int count,
+                                   int32_t *bits) {
+  StkId t;
+  Table *h;
+  unsigned present = 0;
+  int i;
+  lua_lock(L);
+  t = index2addr(L, idx);
+  api_check(L, ttistable(t), "table expected");
+  api_check(L, count <= 32, "too many fields");
+  h = hvalue(t);
+  if (n >= 1 && n - 1 + count <= h->sizearray) {
+    const TValue *a = &h->array[n - 1];
+    for (i = 0; i < count; i++)
+      present |= (unsigned)fix32bits(&a[i], &bits[i]) << i;
+  }
+  else {
+    for (i = 0; i < count; i++)
+      present |= (unsigned)fix32bits(luaH_getint(h, n + i), &bits[i]) << i;
+  }
+  lua_unlock(L);
+  return present;
+}
+
+
 LUA_API void lua_rawgetp (lua_State *L, int idx, const void *p) {
   StkId t;
   TValue k;
@@ -1087,6 +1159,11 @@ LUA_API int lua_gc (lua_State *L, int what, int data) {
       g->gcstepmul = data;
       break;
     }
+    case LUA_GCESTIMATE: {  /* bytes marked live by the last cycle */
+      res = (g->GCestimate > cast(lu_mem, MAX_INT)) ? MAX_INT
+                                                     : cast_int(g->GCestimate);
+      break;
+    }
     case LUA_GCISRUNNING: {
       res = g->gcrunning;
       break;
@@ -934,13 +934,18 @@ static int panic (lua_State *L) {
 }
 
 
-LUALIB_API lua_State *luaL_newstate (void) {
-  lua_State *L = lua_newstate(l_alloc, NULL);
+LUALIB_API lua_State *luaL_newstatef (lua_Alloc f, void *ud) {
+  lua_State *L = lua_newstate(f, ud);
   if (L) lua_atpanic(L, &panic);
   return L;
 }
 
 
+LUALIB_API lua_State *luaL_newstate (void) {
+  return luaL_newstatef(l_alloc, NULL);
+}
+
+
 LUALIB_API void luaL_checkversion_ (lua_State *L, lua_Number ver) {
   const lua_Number *v = lua_version(L);
   if (v != lua_version(NULL))
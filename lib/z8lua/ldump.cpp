@@ -14,6 +14,7 @@
 #include "lua.h"
 
 #include "lobject.h"
+#include "lopcodes.h"
 #include "lstate.h"
 #include "lundump.h"
 
@@ -75,7 +76,21 @@ static void DumpString(const TString* s, DumpState* D)
  }
 }
 
-#define DumpCode(f,D)	 DumpVector(f->code,f->sizecode,sizeof(Instruction),D)
+static void DumpCode(const Proto* f, DumpState* D)
+{
+ int i,n=f->sizecode;
+ DumpInt(n,D);
+ for (i=0; i<n; i++)		/* undo luaV_specialize */
+ {
+  Instruction c=f->code[i];
+  OpCode o=GET_OPCODE(c);
+  if (o==OP_PEEK_K)
+   c=CREATE_ABx(OP_LOADK,GETARG_A(c),GETARG_B(c));
+  else
+   SET_OPCODE(c,genericop(o));
+  DumpVar(c,D);
+ }
+}
 
 static void DumpFunction(const Proto* f, DumpState* D);
 
@@ -781,9 +781,8 @@ static GCObject **sweeptolive (lua_State *L, GCObject **p, int *n) {
 static void checkSizes (lua_State *L) {
   global_State *g = G(L);
   if (g->gckind != KGC_EMERGENCY) {  /* do not change sizes in emergency */
-    int hs = g->strt.size / 2;  /* half the size of the string table */
-    if (g->strt.nuse < cast(lu_int32, hs))  /* using less than that half? */
-      luaS_resize(L, hs);  /* halve its size */
+    if (strtabsparse(&g->strt) && g->strt.size > MINSTRTABSIZE)
+      luaS_resize(L, g->strt.size / 2);  /* halve its size */
     luaZ_freebuffer(L, &g->buff);  /* free concatenation buffer */
   }
 }
@@ -1034,6 +1033,7 @@ static l_mem atomic (lua_State *L) {
   /* clear values from resurrected weak tables */
   clearvalues(g, g->weak, origweak);
   clearvalues(g, g->allweak, origall);
+  luaS_clearsubcache(g);  /* before the flip, while dead strings are white */
   g->currentwhite = cast_byte(otherwhite(g));  /* flip current white */
   work += g->GCmemtrav;  /* complete counting */
   return work;  /* estimate of memory marked by 'atomic' */
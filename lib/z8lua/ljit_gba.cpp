@@ -103,7 +103,7 @@ LuaJitProto *jit = cast(LuaJitProto *, luaM_malloc(L, bytes));
 
     if (op->op == OP_LOADKX || (op->op == OP_SETLIST && op->c == 0)) {
       if (pc + 1 >= p->sizecode || GET_OPCODE(code[pc + 1]) != OP_EXTRAARG) {
-        luaM_free(L, jit);
+        luaM_freemem(L, jit, bytes);
         luaJitDisableProto(L, p);
         return NULL;
       }
@@ -126,7 +126,7 @@ void luaJitFreeProto(lua_State *L, Proto *p) {
   size_t bytes = sizeof(LuaJitProto) + sizeof(LuaJitOp) * (cast(size_t, jit->sizecode) - 1);
   if (g_lua_jit_bytes_used >= bytes) g_lua_jit_bytes_used -= bytes;
   else g_lua_jit_bytes_used = 0;
-  luaM_free(L, jit);
+  luaM_freemem(L, jit, bytes);  /* the pool allocator relies on the exact size */
   p->jit = NULL;
   /* Keep the DISABLED/FAIL_SHOWN bits so we don't thrash recompilation. */
   p->jit_flags &= (LUA_JIT_FLAG_DISABLED | LUA_JIT_FLAG_FAIL_SHOWN);
@@ -145,6 +145,12 @@ typedef lu_int32 Instruction;
 #endif
 
 
+/* size of the short-substring cache (must be power of 2) */
+#if !defined(SUBCACHESIZE)
+#define SUBCACHESIZE	64
+#endif
+
+
 /* minimum size for string buffer */
 #if !defined(LUA_MINBUFFER)
 #define LUA_MINBUFFER	32
@@ -70,6 +70,17 @@ LUAI_DDEF const char *const luaP_opnames[NUM_OPCODES+1] = {
   "CLOSURE",
   "VARARG",
   "EXTRAARG",
+  "ADD_RK",
+  "SUB_RK",
+  "MUL_RK",
+  "SUB_KR",
+  "MUL_KR",
+  "EQ_RK",
+  "LT_RK",
+  "LT_KR",
+  "LE_RK",
+  "LE_KR",
+  "PEEK_K",
   NULL
 };
 
@@ -131,5 +142,23 @@ LUAI_DDEF const lu_byte luaP_opmodes[NUM_OPCODES] = {
  ,opmode(0, 1, OpArgU, OpArgN, iABx)		/* OP_CLOSURE */
  ,opmode(0, 1, OpArgU, OpArgN, iABC)		/* OP_VARARG */
  ,opmode(0, 0, OpArgU, OpArgU, iAx)		/* OP_EXTRAARG */
+ ,opmode(0, 1, OpArgR, OpArgK, iABC)		/* OP_ADD_RK */
+ ,opmode(0, 1, OpArgR, OpArgK, iABC)		/* OP_SUB_RK */
+ ,opmode(0, 1, OpArgR, OpArgK, iABC)		/* OP_MUL_RK */
+ ,opmode(0, 1, OpArgK, OpArgR, iABC)		/* OP_SUB_KR */
+ ,opmode(0, 1, OpArgK, OpArgR, iABC)		/* OP_MUL_KR */
+ ,opmode(1, 0, OpArgR, OpArgK, iABC)		/* OP_EQ_RK */
+ ,opmode(1, 0, OpArgR, OpArgK, iABC)		/* OP_LT_RK */
+ ,opmode(1, 0, OpArgK, OpArgR, iABC)		/* OP_LT_KR */
+ ,opmode(1, 0, OpArgR, OpArgK, iABC)		/* OP_LE_RK */
+ ,opmode(1, 0, OpArgK, OpArgR, iABC)		/* OP_LE_KR */
+ ,opmode(0, 1, OpArgU, OpArgU, iABC)		/* OP_PEEK_K */
+};
+
+
+LUAI_DDEF const lu_byte luaP_generic[NUM_OPCODES - NUM_GENERIC_OPCODES] = {
+  OP_ADD, OP_SUB, OP_MUL, OP_SUB, OP_MUL,
+  OP_EQ, OP_LT, OP_LT, OP_LE, OP_LE,
+  OP_LOADK
 };
 
@@ -235,11 +235,29 @@ OP_CLOSURE,/*	A Bx	R(A) := closure(KPROTO[Bx])			*/
 
 OP_VARARG,/*	A B	R(A), R(A+1), ..., R(A+B-2) = vararg		*/
 
-OP_EXTRAARG/*	Ax	extra (larger) argument for previous opcode	*/
+OP_EXTRAARG,/*	Ax	extra (larger) argument for previous opcode	*/
+
+/* specialised forms, only ever produced by luaV_specialize (see notes) */
+OP_ADD_RK,/*	A B C	R(A) := R(B) + Kst(C)				*/
+OP_SUB_RK,/*	A B C	R(A) := R(B) - Kst(C)				*/
+OP_MUL_RK,/*	A B C	R(A) := R(B) * Kst(C)				*/
+OP_SUB_KR,/*	A B C	R(A) := Kst(B) - R(C)				*/
+OP_MUL_KR,/*	A B C	R(A) := Kst(B) * R(C)				*/
+OP_EQ_RK,/*	A B C	if ((R(B) == Kst(C)) ~= A) then pc++		*/
+OP_LT_RK,/*	A B C	if ((R(B) <  Kst(C)) ~= A) then pc++		*/
+OP_LT_KR,/*	A B C	if ((Kst(B) <  R(C)) ~= A) then pc++		*/
+OP_LE_RK,/*	A B C	if ((R(B) <= Kst(C)) ~= A) then pc++		*/
+OP_LE_KR,/*	A B C	if ((Kst(B) <= R(C)) ~= A) then pc++		*/
+OP_PEEK_K/*	A B C	R(A) := peek(Kst(B), C bytes); pc++		*/
 } OpCode;
 
 
-#define NUM_OPCODES	(cast(int, OP_EXTRAARG) + 1)
+#define NUM_OPCODES	(cast(int, OP_PEEK_K) + 1)
+#define NUM_GENERIC_OPCODES	(cast(int, OP_EXTRAARG) + 1)
+
+/* opcode that a specialised one stands for (itself for the others) */
+#define genericop(o)	((o) < NUM_GENERIC_OPCODES ? (o) : \
+	cast(OpCode, luaP_generic[(o) - NUM_GENERIC_OPCODES]))
 
 
 
@@ -264,6 +282,15 @@ OP_EXTRAARG/*	Ax	extra (larger) argument for previous opcode	*/
 
   (*) All `skips' (pc++) assume that next instruction is a jump.
 
+  (*) The parser only emits the generic opcodes, up to OP_EXTRAARG. Once
+  a function is loaded, luaV_specialize rewrites arithmetic and
+  comparisons with one number constant operand into the _RK/_KR forms,
+  which keep the B and C fields so the generic path can be taken with the
+  operands in their original order. OP_PEEK_K replaces a 'LOADK A k'
+  followed by 'PEEK A A' (or PEEK2/PEEK4), B being the constant index and
+  C the byte count; it skips the peek, which stays in place. Dumped code
+  goes back to the generic opcodes.
+
 ===========================================================================*/
 
 
@@ -294,6 +321,8 @@ LUAI_DDEC const lu_byte luaP_opmodes[NUM_OPCODES];
 
 LUAI_DDEC const char *const luaP_opnames[NUM_OPCODES+1];  /* opcode names */
 
+LUAI_DDEC const lu_byte luaP_generic[NUM_OPCODES - NUM_GENERIC_OPCODES];
+
 
 /* number of list items to accumulate before a SETLIST instruction */
 #define LFIELDS_PER_FLUSH	50
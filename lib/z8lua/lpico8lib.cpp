@@ -19,11 +19,14 @@
 
 #include "lua.h"
 
+#include "lapi.h"
 #include "lauxlib.h"
+#include "lgc.h"
 #include "llimits.h"
 #include "lobject.h"
-
-#include "trigtables.h"
+#include "lstate.h"
+#include "ltable.h"
+#include "lvm.h"
 
 static int pico8_max(lua_State *l) {
     lua_pushnumber(l, lua_Number::max(lua_tonumber(l, 1), lua_tonumber(l, 2)));
@@ -54,63 +57,23 @@ static int pico8_flr(lua_State *l) {
     return 1;
 }
 
-static lua_Number sin_helper(lua_Number x) {
-    // Reduce angle to 0x0 … 0x0.3fff, with the following PICO-8 rules:
-    //  - sin(x) = -sin(x + 0.5)
-    //  - sin(x) equals sin(~x) rather than sin(-x)
-    //  - the last two bits are rounded
-    // We use a lookup table of sin(x)-4x generated by PICO-8 to ensure
-    // that we get the exact same results.
-    auto a = ((x.bits() & 0x4000 ? ~x : x).bits() & 0x3fff) + 2;
-    auto ret = lua_Number::frombits((a >> 2 << 4) + sintable[a >> 2]);
-    return x.bits() & 0x8000 ? ret : -ret;
-}
-
 static int pico8_cos(lua_State *l) {
-    lua_pushnumber(l, sin_helper(lua_tonumber(l, 1) - lua_Number::frombits(0x4000)));
+    lua_pushnumber(l, lua_Number::cos(lua_tonumber(l, 1)));
     return 1;
 }
 
 static int pico8_sin(lua_State *l) {
-    lua_pushnumber(l, sin_helper(lua_tonumber(l, 1)));
+    lua_pushnumber(l, lua_Number::sin(lua_tonumber(l, 1)));
     return 1;
 }
 
 static int pico8_atan2(lua_State *l) {
-    lua_Number x = lua_tonumber(l, 1);
-    lua_Number y = lua_tonumber(l, 2);
-    int32_t bits = 0x4000;
-    if (x) {
-        // Use std::abs() instead of fix32::abs() to emulate PICO-8’s behaviour
-        // with e.g. atan2(0x8000, 0x8000.0001)
-        auto q = (std::abs(int64_t(y.bits())) << 16) / std::abs(int64_t(x.bits()));
-        if (q > 0x10000)
-            bits -= atantable[(int64_t(1) << 32) / q >> 5];
-        else
-            bits = atantable[q >> 5];
-    }
-    if (x.bits() < 0) bits = 0x8000 - bits;
-    if (y.bits() > 0) bits = -bits & 0xffff;
-    // Emulate a bug in PICO-8 with e.g. atan2(1, 0x8000)
-    if (x && y.bits() == int32_t(0x80000000)) bits = -bits & 0xffff;
-    lua_pushnumber(l, lua_Number::frombits(bits));
+    lua_pushnumber(l, lua_Number::atan2(lua_tonumber(l, 1), lua_tonumber(l, 2)));
     return 1;
 }
 
 static int pico8_sqrt(lua_State *l) {
-    int64_t root = 0, x = int64_t(lua_tonumber(l, 1).bits()) << 16;
-    if (x > 0) {
-        // Square root by abacus algorithm, Martin Guy @ UKC, June 1985.
-        // From a book on programming abaci by Mr C. Woo.
-        // Observing a PICO-8 JavaScript export shows the same algorithm.
-        for (int64_t a = int64_t(1) << 46; a; a >>= 2, root >>= 1) {
-            if (x >= a + root) {
-                x -= a + root;
-                root += a << 1;
-            }
-        }
-    }
-    lua_pushnumber(l, lua_Number::frombits(root));
+    lua_pushnumber(l, lua_Number::sqrt(lua_tonumber(l, 1)));
     return 1;
 }
 
@@ -189,20 +152,7 @@ static int pico8_tostr(lua_State *l) {
             break;
         case LUA_TNUMBER: {
             lua_Number x = lua_tonumber(l, 1);
-            if (flags) {
-                uint32_t b = (uint32_t)x.bits();
-                if ((flags & 0x3) == 0x3) {
-                    sprintf(buffer, "0x%04x%04x", (b >> 16) & 0xffff, b & 0xffff);
-                }
-                else if ((flags & 0x2) == 0x2) {
-                    sprintf(buffer, "%d", b);
-                }
-                else {
-                    sprintf(buffer, "0x%04x.%04x", (b >> 16) & 0xffff, b & 0xffff);
-                }
-            } else {
-                lua_number2str(buffer, x);
-            }
+            lua_Number::tostr(buffer, x, flags);
             break;
         }
         case LUA_TSTRING:
@@ -388,6 +338,206 @@ static int pico8_split(lua_State *l) {
     return 1;
 }
 
+//
+// Sequence helpers: add/del/deli/count/all
+//
+// When the whole sequence 1..#t lives in Table::array these shift TValues
+// with memmove instead of going through the API stack one element at a
+// time. Sequences that spill into the hash part, insertions outside
+// 1..#t+1, and del/count of values that may have an __eq metamethod keep
+// the plain rawgeti/rawseti/lua_compare path.
+//
+
+static int pico8_toint(lua_State *l, int n) {
+    if (lua_isboolean(l, n)) return lua_toboolean(l, n) ? 1 : 0;
+    return int(lua_tonumber(l, n));
+}
+
+static inline Table *pico8_table_arg(lua_State *l) {
+    return hvalue(l->ci->func + 1);
+}
+
+static inline bool pico8_in_array(Table *t, int len) {
+    return len <= (int)t->sizearray;
+}
+
+// Only tables and full userdata can have __eq, which may run Lua code and
+// change the table under our feet.
+static inline bool pico8_raw_eq_ok(const TValue *v) {
+    return !ttistable(v) && !ttisuserdata(v);
+}
+
+// Index of the first element of t[1..len] equal to argument 2, or 0.
+static int pico8_find(lua_State *l, Table *t, int len) {
+    const TValue *v = l->ci->func + 2;
+    if (pico8_raw_eq_ok(v) && pico8_in_array(t, len)) {
+        const TValue *a = t->array;
+        for (int i = 0; i < len; ++i)
+            if (luaV_rawequalobj(&a[i], v)) return i + 1;
+        return 0;
+    }
+    for (int i = 1; i <= len; ++i) {
+        lua_rawgeti(l, 1, i);
+        bool eq = lua_compare(l, -1, 2, LUA_OPEQ);
+        lua_pop(l, 1);
+        if (eq) return i;
+    }
+    return 0;
+}
+
+// Removes t[i] and shifts t[i+1..len] down one slot.
+static void pico8_remove(lua_State *l, Table *t, int len, int i) {
+    if (pico8_in_array(t, len)) {
+        TValue *a = t->array;
+        memmove(&a[i - 1], &a[i], (len - i) * sizeof(TValue));
+        setnilvalue(&a[len - 1]);
+        return;
+    }
+    for (; i < len; ++i) {
+        lua_rawgeti(l, 1, i + 1);
+        lua_rawseti(l, 1, i);
+    }
+    lua_pushnil(l);
+    lua_rawseti(l, 1, len);
+}
+
+static int pico8_add(lua_State *l) {
+    luaL_checktype(l, 1, LUA_TTABLE);
+    lua_settop(l, 3);
+    Table *t = pico8_table_arg(l);
+    int len = luaH_getn(t);
+    int idx = lua_isnil(l, 3) ? len + 1 : pico8_toint(l, 3);
+
+    if (idx >= 1 && idx <= len + 1 && pico8_in_array(t, len)) {
+        if (len == (int)t->sizearray)
+            luaH_resizearray(l, t, 1 << luaO_ceillog2(len + 1));
+        // The resize may have run a collection and moved the stack
+        TValue *v = l->ci->func + 2;
+        TValue *a = t->array;
+        memmove(&a[idx], &a[idx - 1], (len + 1 - idx) * sizeof(TValue));
+        setobj2t(l, &a[idx - 1], v);
+        luaC_barrierback(l, obj2gco(t), v);
+    } else {
+        for (int i = len; i >= idx; --i) {
+            lua_rawgeti(l, 1, i);
+            lua_rawseti(l, 1, i + 1);
+        }
+        lua_pushvalue(l, 2);
+        lua_rawseti(l, 1, idx);
+    }
+    lua_pushvalue(l, 2);
+    return 1;
+}
+
+static int pico8_del(lua_State *l) {
+    luaL_checktype(l, 1, LUA_TTABLE);
+    if (lua_gettop(l) < 2) return 0;
+    Table *t = pico8_table_arg(l);
+    int len = luaH_getn(t);
+    int i = pico8_find(l, t, len);
+    if (i == 0) {
+        lua_pushnil(l);
+        return 1;
+    }
+    pico8_remove(l, t, len, i);
+    lua_pushvalue(l, 2);
+    return 1;
+}
+
+static int pico8_deli(lua_State *l) {
+    luaL_checktype(l, 1, LUA_TTABLE);
+    Table *t = pico8_table_arg(l);
+    int len = luaH_getn(t);
+    int idx = lua_gettop(l) >= 2 ? pico8_toint(l, 2) : len;
+    if (idx < 1 || idx > len) {
+        lua_pushnil(l);
+        return 1;
+    }
+    lua_rawgeti(l, 1, idx);
+    pico8_remove(l, t, len, idx);
+    return 1;
+}
+
+static int pico8_count(lua_State *l) {
+    if (lua_isnil(l, 1)) {
+        lua_pushinteger(l, 0);
+        return 1;
+    }
+    luaL_checktype(l, 1, LUA_TTABLE);
+    Table *t = pico8_table_arg(l);
+    int len = luaH_getn(t);
+    if (lua_gettop(l) == 1 || lua_isnil(l, 2)) {
+        lua_pushinteger(l, len);
+        return 1;
+    }
+    int n = 0;
+    const TValue *v = l->ci->func + 2;
+    if (pico8_raw_eq_ok(v) && pico8_in_array(t, len)) {
+        const TValue *a = t->array;
+        for (int i = 0; i < len; ++i)
+            n += luaV_rawequalobj(&a[i], v);
+    } else {
+        for (int i = 1; i <= len; ++i) {
+            lua_rawgeti(l, 1, i);
+            n += lua_compare(l, -1, 2, LUA_OPEQ);
+            lua_pop(l, 1);
+        }
+    }
+    lua_pushinteger(l, n);
+    return 1;
+}
+
+static int pico8_all_none(lua_State *l) {
+    (void)l;
+    return 0;
+}
+
+// Iterator returned by all(). Upvalues: table, index, previous value.
+// Same rules as PICO-8's all(): if t[i] still holds the value returned last
+// time, step past it, otherwise it was deleted and t[i] is the next element;
+// nil holes below #t are skipped.
+static int pico8_all_iter(lua_State *l) {
+    CClosure *cl = clCvalue(l->ci->func);
+    TValue *up = cl->upvalue;
+    if (!ttistable(&up[0])) return 0; // already finished
+
+    Table *t = hvalue(&up[0]);
+    int i = int(nvalue(&up[1]));
+    int len = luaH_getn(t);
+    if (luaV_rawequalobj(luaH_getint(t, i), &up[2])) ++i;
+    while (i <= len && ttisnil(luaH_getint(t, i))) ++i;
+
+    const TValue *v = luaH_getint(t, i);
+    if (!ttisnil(v)) {
+        setnvalue(&up[1], lua_Number(i));
+        setobj(l, &up[2], v);
+        luaC_barrier(l, cl, v);
+        setobj2s(l, l->top, v);
+        api_incr_top(l);
+        return 1;
+    }
+
+    // Done: drop the references so a stored iterator doesn't pin the table.
+    setnilvalue(&up[0]);
+    setnilvalue(&up[2]);
+    return 0;
+}
+
+// Lua's generic for makes the loop value the control variable, so the
+// index has to live in the closure rather than in a stateless triple.
+static int pico8_all(lua_State *l) {
+    if (lua_isnil(l, 1)) {
+        lua_pushcfunction(l, pico8_all_none);
+        return 1;
+    }
+    luaL_checktype(l, 1, LUA_TTABLE);
+    lua_settop(l, 1);
+    lua_pushinteger(l, 1);
+    lua_pushnil(l);
+    lua_pushcclosure(l, pico8_all_iter, 3);
+    return 1;
+}
+
 static const luaL_Reg pico8lib[] = {
   {"max",   pico8_max},
   {"min",   pico8_min},
@@ -414,6 +564,11 @@ static const luaL_Reg pico8lib[] = {
   {"chr",   pico8_chr},
   {"ord",   pico8_ord},
   {"split", pico8_split},
+  {"add",   pico8_add},
+  {"del",   pico8_del},
+  {"deli",  pico8_deli},
+  {"count", pico8_count},
+  {"all",   pico8_all},
   {NULL, NULL}
 };
 
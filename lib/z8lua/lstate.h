@@ -106,6 +106,17 @@ typedef struct CallInfo {
 #define isLua(ci)	((ci)->callstatus & CIST_LUA)
 
 
+/*
+** z8lua: a substring 'res' of 'src' starting at byte 'start'. Entries are
+** not GC roots; 'atomic' drops any whose strings are about to be swept.
+*/
+typedef struct SubCache {
+  TString *src;  /* NULL for an empty slot */
+  TString *res;
+  size_t start;
+} SubCache;
+
+
 /*
 ** `global state', shared by all threads of this state
 */
@@ -145,6 +156,8 @@ typedef struct global_State {
   const lua_Number *version;  /* pointer to version number */
   TString *memerrmsg;  /* memory-error message */
   TString *tmname[TM_N];  /* array with tag-method names */
+  TString *charstr[256];  /* one-byte strings, interned on first use */
+  SubCache subcache[SUBCACHESIZE];  /* recent short substrings */
   struct Table *mt[LUA_NUMTAGS];  /* metatables for basic types */
 } global_State;
 
@@ -50,12 +50,40 @@ int luaS_eqstr (TString *a, TString *b) {
 }
 
 
+/*
+** z8lua: short strings (keys, '..' results, tostr/split output) are
+** hashed four bytes at a time with a multiply-xorshift mix, which is
+** cheaper than the byte loop and spreads "item1", "item2"... better.
+** Long strings keep the sampling hash so huge ones stay cheap.
+*/
+#define HASHMUL1	0x9e3779b1u
+#define HASHMUL2	0x85ebca77u
+
 unsigned int luaS_hash (const char *str, size_t l, unsigned int seed) {
-  unsigned int h = seed ^ cast(unsigned int, l);
-  size_t l1;
-  size_t step = (l >> LUAI_HASHLIMIT) + 1;
-  for (l1 = l; l1 >= step; l1 -= step)
-    h = h ^ ((h<<5) + (h>>2) + cast_byte(str[l1 - 1]));
+  lu_int32 h = seed ^ cast(lu_int32, l);
+  if (l <= LUAI_MAXSHORTLEN) {
+    lu_int32 w;
+    for (; l >= 4; str += 4, l -= 4) {
+      memcpy(&w, str, 4);
+      h = (h ^ w) * HASHMUL1;
+      h ^= h >> 15;
+    }
+    if (l > 0) {
+      w = cast_byte(str[0]);
+      if (l > 1) w |= cast(lu_int32, cast_byte(str[1])) << 8;
+      if (l > 2) w |= cast(lu_int32, cast_byte(str[2])) << 16;
+      h = (h ^ w) * HASHMUL1;
+    }
+    h ^= h >> 16;
+    h *= HASHMUL2;
+    h ^= h >> 13;
+  }
+  else {
+    size_t l1;
+    size_t step = (l >> LUAI_HASHLIMIT) + 1;
+    for (l1 = l; l1 >= step; l1 -= step)
+      h = h ^ ((h<<5) + (h>>2) + cast_byte(str[l1 - 1]));
+  }
   return h;
 }
 
@@ -120,7 +148,7 @@ static TString *newshrstr (lua_State *L, const char *str, size_t l,
   GCObject **list;  /* (pointer to) list where it will be inserted */
   stringtable *tb = &G(L)->strt;
   TString *s;
-  if (tb->nuse >= cast(lu_int32, tb->size) && tb->size <= MAX_INT/2)
+  if (strtabfull(tb) && tb->size <= MAX_INT/2)
     luaS_resize(L, tb->size*2);  /* too crowded */
   list = &tb->hash[lmod(h, tb->size)];
   s = createstrobj(L, str, l, LUA_TSHRSTR, h, list);
@@ -156,6 +184,8 @@ static TString *internshrstr (lua_State *L, const char *str, size_t l) {
 ** new string (with explicit length)
 */
 TString *luaS_newlstr (lua_State *L, const char *str, size_t l) {
+  if (l == 1)  /* str[i], sub(s,i,i), chr(): skip hashing and lookup */
+    return luaS_newchar(L, *str);
   if (l <= LUAI_MAXSHORTLEN)  /* short string? */
     return internshrstr(L, str, l);
   else {
@@ -166,6 +196,63 @@ TString *luaS_newlstr (lua_State *L, const char *str, size_t l) {
 }
 
 
+/*
+** intern the one-byte string for c on first use and keep it in 'charstr';
+** it is fixed, so the cached pointer never dangles. Created lazily so a
+** cart only pays for the characters it actually uses.
+*/
+TString *luaS_internchar (lua_State *L, int c) {
+  char ch = cast(char, c);
+  TString *ts = internshrstr(L, &ch, 1);
+  luaS_fix(ts);
+  G(L)->charstr[c] = ts;
+  return ts;
+}
+
+
+/*
+** substring of 'src' at byte offset 'i'. The whole string is 'src' itself
+** and one byte comes from 'charstr'; other short substrings go through a
+** small cache so repeated sub() calls on the same text (per-frame text
+** rendering, re-parsed strings) skip the hash and the intern lookup.
+*/
+TString *luaS_newsub (lua_State *L, TString *src, size_t i, size_t l) {
+  const char *str = getstr(src) + i;
+  if (l == src->tsv.len)
+    return src;
+  if (l == 1)
+    return luaS_newchar(L, *str);
+  if (l <= LUAI_MAXSHORTLEN) {
+    SubCache *e = &G(L)->subcache[lmod((IntPoint(src) >> 3) ^
+                                       cast(unsigned int, i << 4) ^
+                                       cast(unsigned int, l), SUBCACHESIZE)];
+    if (e->src != src || e->start != i || e->res->tsv.len != l) {
+      TString *ts = internshrstr(L, str, l);
+      e->src = src;
+      e->res = ts;
+      e->start = i;
+    }
+    return e->res;
+  }
+  return luaS_newlstr(L, str, l);
+}
+
+
+/*
+** called from 'atomic': forget entries whose source or result was not
+** reached, so a freed string's address is never matched again
+*/
+void luaS_clearsubcache (global_State *g) {
+  int i;
+  for (i = 0; i < SUBCACHESIZE; i++) {
+    SubCache *e = &g->subcache[i];
+    if (e->src != NULL &&
+        (iswhite(obj2gco(e->src)) || iswhite(obj2gco(e->res))))
+      e->src = e->res = NULL;
+  }
+}
+
+
 /*
 ** new zero-terminated string
 */
@@ -21,6 +21,13 @@
 
 #define luaS_fix(s)	l_setbit((s)->tsv.marked, FIXEDBIT)
 
+/*
+** one-byte string for character c
+*/
+#define luaS_newchar(L,c)  \
+	(G(L)->charstr[cast_byte(c)] ? G(L)->charstr[cast_byte(c)] : \
+	 luaS_internchar(L, cast_byte(c)))
+
 
 /*
 ** test whether a string is a reserved word
@@ -34,6 +41,26 @@
 #define eqshrstr(a,b)	check_exp((a)->tsv.tt == LUA_TSHRSTR, (a) == (b))
 
 
+/*
+** z8lua: string table load factor, in strings per 4 buckets. The table
+** doubles once it is that full and the collector halves it below a
+** quarter of that; the gap keeps carts whose strings come and go every
+** frame from resizing the table every cycle. The GBA trades longer
+** chains for half the bucket array.
+*/
+#if !defined(LUAI_STRTABLOAD)
+#if defined(__GBA__)
+#define LUAI_STRTABLOAD	4
+#else
+#define LUAI_STRTABLOAD	3
+#endif
+#endif
+
+#define strtabfull(tb) \
+	((tb)->nuse >= cast(lu_int32, (tb)->size >> 2) * LUAI_STRTABLOAD)
+#define strtabsparse(tb) \
+	((tb)->nuse < cast(lu_int32, (tb)->size >> 4) * LUAI_STRTABLOAD)
+
 LUAI_FUNC unsigned int luaS_hash (const char *str, size_t l, unsigned int seed);
 LUAI_FUNC int luaS_eqlngstr (TString *a, TString *b);
 LUAI_FUNC int luaS_eqstr (TString *a, TString *b);
@@ -41,6 +68,9 @@ LUAI_FUNC void luaS_resize (lua_State *L, int newsize);
 LUAI_FUNC Udata *luaS_newudata (lua_State *L, size_t s, Table *e);
 LUAI_FUNC TString *luaS_newlstr (lua_State *L, const char *str, size_t l);
 LUAI_FUNC TString *luaS_new (lua_State *L, const char *str);
+LUAI_FUNC TString *luaS_internchar (lua_State *L, int c);
+LUAI_FUNC TString *luaS_newsub (lua_State *L, TString *src, size_t i, size_t l);
+LUAI_FUNC void luaS_clearsubcache (global_State *g);
 
 
 #endif
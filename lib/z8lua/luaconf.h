@@ -559,6 +559,7 @@
 #undef LUAI_UACNUMBER
 
 #undef lua_number2str
+#undef lua_str2number
 #undef l_mathop
 
 #if defined(LUA_USE_READLINE)
@@ -589,11 +590,8 @@
 #define luai_numpeek2(L,a)	(luaV_peek(L,a,2))
 #define luai_numpeek4(L,a)	(luaV_peek(L,a,4))
 
-#define lua_number2str(s,n) [&]() { \
-  int i = sprintf(s, "%1.4f", (double)n); \
-  while (i > 0 && s[i - 1] == '0') s[--i] = '\0'; \
-  if (i > 0 && s[i - 1] == '.') s[--i] = '\0'; \
-  return i; }()
+#define lua_number2str(s,n) (z8::fix32::tostr((s), (n)))
+#define lua_str2number(s,p) (z8::fix32::fromstr((s), (p)))
 
 #define luai_hashnum(i,n) (i = (n * z8::fix32::frombits(2654435769u)).bits())
 
@@ -130,7 +130,7 @@ void luaV_gettable (lua_State *L, const TValue *t, TValue *key, StkId val) {
     if (idx >= ls)
       setnilvalue(val);
     else
-      setsvalue2s(L, val, luaS_newlstr(L, s + idx, 1));
+      setsvalue2s(L, val, luaS_newchar(L, s[idx]));
     return;
   }
   int loop;
@@ -337,28 +337,37 @@ int luaV_equalobj_ (lua_State *L, const TValue *t1, const TValue *t2) {
 }
 
 
+/*
+** z8lua: numbers are not interned before being joined, they are formatted
+** straight into the buffer. Room for the longest number text is reserved
+** and the length actually written is counted while copying.
+*/
+#define concatable(o)	(ttisstring(o) || ttisnumber(o))
+#define concatlen(o)	(ttisstring(o) ? tsvalue(o)->len : LUAI_MAXNUMBER2STR)
+
 void luaV_concat (lua_State *L, int total) {
   lua_assert(total >= 2);
   do {
     StkId top = L->top;
     int n = 2;  /* number of elements handled in this pass (at least 2) */
-    if (!(ttisstring(top-2) || ttisnumber(top-2)) || !tostring(L, top-1)) {
+    if (!concatable(top-2) || !concatable(top-1)) {
       if (!call_binTM(L, top-2, top-1, top-2, TM_CONCAT))
         luaG_concaterror(L, top-2, top-1);
     }
-    else if (tsvalue(top-1)->len == 0)  /* second operand is empty? */
+    else if (ttisstring(top-1) && tsvalue(top-1)->len == 0)  /* second operand is empty? */
       (void)tostring(L, top - 2);  /* result is first operand */
     else if (ttisstring(top-2) && tsvalue(top-2)->len == 0) {
+      (void)tostring(L, top - 1);
       setobjs2s(L, top - 2, top - 1);  /* result is second op. */
     }
     else {
       /* at least two non-empty string values; get as many as possible */
-      size_t tl = tsvalue(top-1)->len;
+      size_t tl = concatlen(top-1);
       char *buffer;
       int i;
       /* collect total length */
-      for (i = 1; i < total && tostring(L, top-i-1); i++) {
-        size_t l = tsvalue(top-i-1)->len;
+      for (i = 1; i < total && concatable(top-i-1); i++) {
+        size_t l = concatlen(top-i-1);
         if (l >= (MAX_SIZET/sizeof(char)) - tl)
           luaG_runerror(L, "string length overflow");
         tl += l;
@@ -367,9 +376,14 @@ void luaV_concat (lua_State *L, int total) {
       tl = 0;
       n = i;
       do {  /* concat all strings */
-        size_t l = tsvalue(top-i)->len;
-        memcpy(buffer+tl, svalue(top-i), l * sizeof(char));
-        tl += l;
+        StkId o = top-i;
+        if (ttisstring(o)) {
+          size_t l = tsvalue(o)->len;
+          memcpy(buffer+tl, svalue(o), l * sizeof(char));
+          tl += l;
+        }
+        else
+          tl += lua_number2str(buffer+tl, nvalue(o));
       } while (--i > 0);
       setsvalue2s(L, top-n, luaS_newlstr(L, buffer, tl));
     }
@@ -471,7 +485,7 @@ void luaV_finishOp (lua_State *L) {
   CallInfo *ci = L->ci;
   StkId base = ci->u.l.base;
   Instruction inst = *(ci->u.l.savedpc - 1);  /* interrupted instruction */
-  OpCode op = GET_OPCODE(inst);
+  OpCode op = genericop(GET_OPCODE(inst));
   switch (op) {  /* finish its execution */
     case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV:
     case OP_MOD: case OP_POW: case OP_IDIV: case OP_BAND:
@@ -527,6 +541,98 @@ void luaV_finishOp (lua_State *L) {
 
 
 
+/*
+** {==================================================================
+** Load-time specialisation (see the notes in lopcodes.h)
+** ===================================================================
+*/
+
+static int isnumk (const Proto *p, int rk) {
+  return ISK(rk) && ttisnumber(&p->k[INDEXK(rk)]);
+}
+
+
+/* can control reach 'target' other than from the instruction before it? */
+static int isjumptarget (const Proto *p, int target) {
+  int pc;
+  for (pc = 0; pc < p->sizecode; pc++) {
+    Instruction i = p->code[pc];
+    switch (GET_OPCODE(i)) {
+      case OP_JMP: case OP_FORLOOP: case OP_FORPREP: case OP_TFORLOOP:
+        if (pc + 1 + GETARG_sBx(i) == target) return 1;
+        break;
+      case OP_LOADBOOL:
+        if (GETARG_C(i) && pc + 2 == target) return 1;
+        break;
+      default:
+        if (testTMode(GET_OPCODE(i)) && pc + 2 == target) return 1;
+        break;
+    }
+  }
+  return 0;
+}
+
+
+static void specialize_peek (Proto *p, int pc) {
+  Instruction i = p->code[pc];
+  Instruction next = p->code[pc + 1];
+  int a = GETARG_A(i), bx = GETARG_Bx(i);
+  int count;
+  switch (GET_OPCODE(next)) {
+    case OP_PEEK: count = 1; break;
+    case OP_PEEK2: count = 2; break;
+    case OP_PEEK4: count = 4; break;
+    default: return;
+  }
+  if (GETARG_A(next) != a || GETARG_B(next) != a || bx > MAXARG_B ||
+      !ttisnumber(&p->k[bx]) || isjumptarget(p, pc + 1))
+    return;
+  p->code[pc] = CREATE_ABC(OP_PEEK_K, a, bx, count);
+}
+
+
+void luaV_specialize (Proto *p) {
+  int pc;
+  for (pc = 0; pc < p->sizecode; pc++) {
+    Instruction *i = &p->code[pc];
+    int b = GETARG_B(*i), c = GETARG_C(*i);
+    switch (GET_OPCODE(*i)) {
+      case OP_ADD:
+        if (!ISK(b) && isnumk(p, c)) SET_OPCODE(*i, OP_ADD_RK);
+        break;
+      case OP_SUB:
+        if (!ISK(b) && isnumk(p, c)) SET_OPCODE(*i, OP_SUB_RK);
+        else if (isnumk(p, b) && !ISK(c)) SET_OPCODE(*i, OP_SUB_KR);
+        break;
+      case OP_MUL:
+        if (!ISK(b) && isnumk(p, c)) SET_OPCODE(*i, OP_MUL_RK);
+        else if (isnumk(p, b) && !ISK(c)) SET_OPCODE(*i, OP_MUL_KR);
+        break;
+      case OP_EQ:
+        if (!ISK(b) && isnumk(p, c)) SET_OPCODE(*i, OP_EQ_RK);
+        break;
+      case OP_LT:
+        if (!ISK(b) && isnumk(p, c)) SET_OPCODE(*i, OP_LT_RK);
+        else if (isnumk(p, b) && !ISK(c)) SET_OPCODE(*i, OP_LT_KR);
+        break;
+      case OP_LE:
+        if (!ISK(b) && isnumk(p, c)) SET_OPCODE(*i, OP_LE_RK);
+        else if (isnumk(p, b) && !ISK(c)) SET_OPCODE(*i, OP_LE_KR);
+        break;
+      case OP_LOADK:
+        if (pc + 1 < p->sizecode) specialize_peek(p, pc);
+        break;
+      default: break;
+    }
+  }
+  for (pc = 0; pc < p->sizep; pc++)
+    luaV_specialize(p->p[pc]);
+}
+
+/* }================================================================== */
+
+
+
 /*
 ** some macros for common tasks in `luaV_execute'
 */
@@ -584,6 +690,41 @@ void luaV_finishOp (lua_State *L) {
         } \
         else { Protect(luaV_arith(L, ra, rb, rb, tm)); } }
 
+/* one operand is a number constant: R(B) op Kst(C), or Kst(B) op R(C) */
+#define arith_rk(op,tm) { \
+        TValue *rb = base+GETARG_B(i); \
+        TValue *kc = k+INDEXK(GETARG_C(i)); \
+        if (ttisnumber(rb)) { \
+          setnvalue(ra, op(L, nvalue(rb), nvalue(kc))); \
+        } \
+        else { Protect(luaV_arith(L, ra, rb, kc, tm)); } }
+
+#define arith_kr(op,tm) { \
+        TValue *kb = k+INDEXK(GETARG_B(i)); \
+        TValue *rc = base+GETARG_C(i); \
+        if (ttisnumber(rc)) { \
+          setnvalue(ra, op(L, nvalue(kb), nvalue(rc))); \
+        } \
+        else { Protect(luaV_arith(L, ra, kb, rc, tm)); } }
+
+#define compare_rk(op,f) { \
+        TValue *rb = base+GETARG_B(i); \
+        TValue *kc = k+INDEXK(GETARG_C(i)); \
+        int res; \
+        if (ttisnumber(rb)) res = op(L, nvalue(rb), nvalue(kc)); \
+        else { Protect(res = f(L, rb, kc)); } \
+        if (res != GETARG_A(i)) ci->u.l.savedpc++; \
+        else donextjump(ci); }
+
+#define compare_kr(op,f) { \
+        TValue *kb = k+INDEXK(GETARG_B(i)); \
+        TValue *rc = base+GETARG_C(i); \
+        int res; \
+        if (ttisnumber(rc)) res = op(L, nvalue(kb), nvalue(rc)); \
+        else { Protect(res = f(L, kb, rc)); } \
+        if (res != GETARG_A(i)) ci->u.l.savedpc++; \
+        else donextjump(ci); }
+
 #define vmdispatch(o)	switch(o)
 #define vmcase(l,b)	case l: {b}  break;
 #define vmcasenb(l,b)	case l: {b}		/* nb = no break */
@@ -953,6 +1094,45 @@ void luaV_execute (lua_State *L) {
           }
         }
       )
+      vmcase(OP_ADD_RK,
+        arith_rk(luai_numadd, TM_ADD);
+      )
+      vmcase(OP_SUB_RK,
+        arith_rk(luai_numsub, TM_SUB);
+      )
+      vmcase(OP_MUL_RK,
+        arith_rk(luai_nummul, TM_MUL);
+      )
+      vmcase(OP_SUB_KR,
+        arith_kr(luai_numsub, TM_SUB);
+      )
+      vmcase(OP_MUL_KR,
+        arith_kr(luai_nummul, TM_MUL);
+      )
+      vmcase(OP_EQ_RK,
+        TValue *rb = base+GETARG_B(i);
+        TValue *kc = k+INDEXK(GETARG_C(i));
+        /* no metamethod can be involved with a number operand */
+        int res = ttisnumber(rb) && luai_numeq(nvalue(rb), nvalue(kc));
+        if (res != GETARG_A(i)) ci->u.l.savedpc++;
+        else donextjump(ci);
+      )
+      vmcase(OP_LT_RK,
+        compare_rk(luai_numlt, luaV_lessthan);
+      )
+      vmcase(OP_LT_KR,
+        compare_kr(luai_numlt, luaV_lessthan);
+      )
+      vmcase(OP_LE_RK,
+        compare_rk(luai_numle, luaV_lessequal);
+      )
+      vmcase(OP_LE_KR,
+        compare_kr(luai_numle, luaV_lessequal);
+      )
+      vmcase(OP_PEEK_K,
+        setnvalue(ra, luaV_peek(L, nvalue(k+GETARG_B(i)), GETARG_C(i)));
+        ci->u.l.savedpc++;  /* skip the PEEK it was fused with */
+      )
       vmcase(OP_EXTRAARG,
         lua_assert(0);
       )
@@ -1066,7 +1246,18 @@ newframe:  /* reentry point when frame changes (call/return) */
     &&L_OP_SETLIST,
     &&L_OP_CLOSURE,
     &&L_OP_VARARG,
-    &&L_OP_EXTRAARG
+    &&L_OP_EXTRAARG,
+    &&L_OP_ADD_RK,
+    &&L_OP_SUB_RK,
+    &&L_OP_MUL_RK,
+    &&L_OP_SUB_KR,
+    &&L_OP_MUL_KR,
+    &&L_OP_EQ_RK,
+    &&L_OP_LT_RK,
+    &&L_OP_LT_KR,
+    &&L_OP_LE_RK,
+    &&L_OP_LE_KR,
+    &&L_OP_PEEK_K
   };
 
   LuaJitOp *op;
@@ -1101,6 +1292,31 @@ newframe:  /* reentry point when frame changes (call/return) */
     setnvalue(ra, opfn(L, nb)); \
   } \
   else { JIT_PROTECT(luaV_arith(L, ra, rb, rb, tm)); } }
+#define JIT_ARITH_RK(opfn,tm) { \
+  TValue *rb = base + op->b; \
+  TValue *kc = k + INDEXK(op->c); \
+  if (ttisnumber(rb)) { \
+    setnvalue(ra, opfn(L, nvalue(rb), nvalue(kc))); \
+  } \
+  else { JIT_PROTECT(luaV_arith(L, ra, rb, kc, tm)); } }
+#define JIT_ARITH_KR(opfn,tm) { \
+  TValue *kb = k + INDEXK(op->b); \
+  TValue *rc = base + op->c; \
+  if (ttisnumber(rc)) { \
+    setnvalue(ra, opfn(L, nvalue(kb), nvalue(rc))); \
+  } \
+  else { JIT_PROTECT(luaV_arith(L, ra, kb, rc, tm)); } }
+#define JIT_COMPARE(lv,rv,numop,f) { \
+  TValue *l = (lv); \
+  TValue *r = (rv); \
+  int res; \
+  if (ttisnumber(l) && ttisnumber(r)) res = numop(L, nvalue(l), nvalue(r)); \
+  else { JIT_PROTECT(res = f(L, l, r)); } \
+  if (res != op->a) { \
+    pc = op + 2; \
+    goto jit_dispatch; \
+  } \
+  JIT_NEXTJUMP(); }
 #define JIT_NEXT() do { pc = op + 1; goto jit_dispatch; } while (0)
 #define JIT_JUMP(jop) do { \
   int a = (jop)->a; \
@@ -1554,6 +1770,32 @@ L_OP_EXTRAARG:
   lua_assert(0);
   JIT_NEXT();
 
+L_OP_ADD_RK: JIT_ARITH_RK(luai_numadd, TM_ADD); JIT_NEXT();
+L_OP_SUB_RK: JIT_ARITH_RK(luai_numsub, TM_SUB); JIT_NEXT();
+L_OP_MUL_RK: JIT_ARITH_RK(luai_nummul, TM_MUL); JIT_NEXT();
+L_OP_SUB_KR: JIT_ARITH_KR(luai_numsub, TM_SUB); JIT_NEXT();
+L_OP_MUL_KR: JIT_ARITH_KR(luai_nummul, TM_MUL); JIT_NEXT();
+
+L_OP_EQ_RK: {
+  TValue *rb = base + op->b;
+  TValue *kc = k + INDEXK(op->c);
+  if ((ttisnumber(rb) && luai_numeq(nvalue(rb), nvalue(kc))) != op->a) {
+    pc = op + 2;
+    goto jit_dispatch;
+  }
+  JIT_NEXTJUMP();
+}
+
+L_OP_LT_RK: JIT_COMPARE(base + op->b, k + INDEXK(op->c), luai_numlt, luaV_lessthan);
+L_OP_LT_KR: JIT_COMPARE(k + INDEXK(op->b), base + op->c, luai_numlt, luaV_lessthan);
+L_OP_LE_RK: JIT_COMPARE(base + op->b, k + INDEXK(op->c), luai_numle, luaV_lessequal);
+L_OP_LE_KR: JIT_COMPARE(k + INDEXK(op->b), base + op->c, luai_numle, luaV_lessequal);
+
+L_OP_PEEK_K:
+  setnvalue(ra, luaV_peek(L, nvalue(k + op->b), op->c));
+  pc = op + 2;  /* skip the PEEK it was fused with */
+  goto jit_dispatch;
+
 #undef JIT_BX
 #undef JIT_SBX
 #undef JIT_RB
@@ -1564,6 +1806,9 @@ L_OP_EXTRAARG:
 #undef JIT_CHECKGC
 #undef JIT_ARITH_OP
 #undef JIT_UNARY_OP
+#undef JIT_ARITH_RK
+#undef JIT_ARITH_KR
+#undef JIT_COMPARE
 #undef JIT_NEXT
 #undef JIT_JUMP
 #undef JIT_NEXTJUMP
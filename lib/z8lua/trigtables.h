@@ -15,7 +15,7 @@
 
 // This table was generated using the following PICO-8 code:
 //   for i = 0,0.25,0x.0004 do x = i * -4 - sin(i) printh('0x'..sub(tostr(x,1),8,11)..', ') end
-static uint16_t sintable[] =
+static const uint16_t sintable[] =
 {
     0x0000, 0x0009, 0x0012, 0x001b, 0x0025, 0x002e, 0x0037, 0x0040, 0x0049, 0x0052, 0x005b, 0x0064, 0x006e, 0x0077, 0x0080, 0x0089,
     0x0092, 0x009b, 0x00a4, 0x00ae, 0x00b7, 0x00c0, 0x00c9, 0x00d2, 0x00db, 0x00e4, 0x00ed, 0x00f7, 0x0100, 0x0109, 0x0112, 0x011b,
@@ -273,11 +273,12 @@ static uint16_t sintable[] =
     0x02f5, 0x02e5, 0x02d6, 0x02c6, 0x02b7, 0x02a7, 0x0297, 0x0288, 0x0278, 0x0269, 0x0259, 0x0249, 0x023a, 0x022a, 0x021a, 0x020b,
     0x01fb, 0x01eb, 0x01dc, 0x01cc, 0x01bc, 0x01ac, 0x019d, 0x018d, 0x017d, 0x016d, 0x015e, 0x014e, 0x013e, 0x012e, 0x011e, 0x010f,
     0x00ff, 0x00ef, 0x00df, 0x00cf, 0x00bf, 0x00af, 0x00a0, 0x0090, 0x0080, 0x0070, 0x0060, 0x0050, 0x0040, 0x0030, 0x0020, 0x0010,
+    0x0000, // i = 0.25, reached when x rounds up to a quarter turn
 };
 
 // This table was generated using the following PICO-8 code:
 //   for i=0,1,0x.002 do printh('0x'..sub(tostr(atan2(1,-i),1),8,13)) end
-static uint16_t atantable[] =
+static const uint16_t atantable[] =
 {
     0x0000, 0x0005, 0x000a, 0x000f, 0x0014, 0x0019, 0x001f, 0x0024, 0x0029, 0x002e, 0x0033, 0x0038, 0x003d, 0x0042, 0x0047, 0x004c,
     0x0051, 0x0057, 0x005c, 0x0061, 0x0066, 0x006b, 0x0070, 0x0075, 0x007a, 0x007f, 0x0084, 0x008a, 0x008f, 0x0094, 0x0099, 0x009e,
@@ -5,6 +5,17 @@
 #include <cmath>
 #include <algorithm>
 #include <cstring>
+#include <vector>
+
+#if !defined(__GBA__)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define REAL8_RESAMPLE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define REAL8_RESAMPLE_NEON 1
+#endif
+#endif
 
 // --------------------------------------------------------------------------
 // CONSTANTS
@@ -164,6 +175,74 @@ static float get_sample_for_state(ChannelState &state, int waveform, float freq)
     }
 }
 
+// --------------------------------------------------------------------------
+// SEGMENT RENDERERS (fixed pitch between sequencer ticks)
+// --------------------------------------------------------------------------
+
+static constexpr int kMixSegment = 256;
+
+template <float (*Osc)(float)>
+static void render_tone(ChannelState &state, float dt, float vol, float* mix, int n, bool audible) {
+    float phi = state.phi;
+    for (int j = 0; j < n; j++) {
+        phi += dt;
+        if (phi >= 1.0f) phi -= 1.0f;
+        if (audible) mix[j] += Osc(phi) * vol;
+    }
+    state.phi = phi;
+}
+
+// The noise LFSR (15 bits, taps 0 and 1, feedback into bit 14) shifts out a
+// bit stream obeying s[n+15] = s[n] ^ s[n+1]. XORing the register with
+// itself shifted by one therefore yields the next 14 stream bits at once:
+// after k <= 14 steps the register is (window >> k) & 0x7FFF and the noise
+// output is bit k of the window. The window is refilled every 14 steps.
+static constexpr int kLfsrLeap = 14;
+
+static inline uint32_t lfsr_window(uint32_t lfsr) {
+    return lfsr | (((lfsr ^ (lfsr >> 1)) & 0x3FFF) << 15);
+}
+
+static void render_noise(ChannelState &state, float dt, float vol, float* mix, int n, bool audible) {
+    if (state.lfsr > 0x7FFF) {
+        // Out-of-range register (old snapshot); step it one bit at a time.
+        for (int j = 0; j < n; j++) {
+            float old_phi = state.phi;
+            state.phi += dt;
+            if (state.phi >= 1.0f) state.phi -= 1.0f;
+            if (state.phi < old_phi) {
+                uint32_t b = (state.lfsr & 1) ^ ((state.lfsr >> 1) & 1);
+                state.lfsr = (state.lfsr >> 1) | (b << 14);
+                state.noise_sample = (state.lfsr & 1) ? 1.0f : -1.0f;
+            }
+            if (audible) mix[j] += state.noise_sample * vol;
+        }
+        return;
+    }
+
+    uint32_t window = lfsr_window(state.lfsr);
+    int used = 0;
+    float phi = state.phi;
+    float noise = state.noise_sample;
+    for (int j = 0; j < n; j++) {
+        float old_phi = phi;
+        phi += dt;
+        if (phi >= 1.0f) phi -= 1.0f;
+        if (phi < old_phi) {
+            if (used == kLfsrLeap) {
+                window = lfsr_window((window >> kLfsrLeap) & 0x7FFF);
+                used = 0;
+            }
+            used++;
+            noise = ((window >> used) & 1) ? 1.0f : -1.0f;
+        }
+        if (audible) mix[j] += noise * vol;
+    }
+    state.phi = phi;
+    state.noise_sample = noise;
+    state.lfsr = (window >> used) & 0x7FFF;
+}
+
 // --------------------------------------------------------------------------
 // AUDIO ENGINE IMPLEMENTATION
 // --------------------------------------------------------------------------
@@ -184,6 +263,172 @@ void AudioEngine::init(Real8VM *parent) {
     }
 }
 
+#if !defined(__GBA__)
+// --------------------------------------------------------------------------
+// RESAMPLER
+// --------------------------------------------------------------------------
+
+// Sum of (k[i] + t * d[i]) * x[i] over TAPS: the kernel is linearly
+// interpolated between the two nearest phases before the dot product.
+static inline float resample_dot(const float* k, const float* d, float t, const float* x) {
+#if defined(REAL8_RESAMPLE_SSE2)
+    const __m128 vt = _mm_set1_ps(t);
+    __m128 acc = _mm_setzero_ps();
+    for (int i = 0; i < AudioResampler::TAPS; i += 4) {
+        __m128 c = _mm_add_ps(_mm_load_ps(k + i), _mm_mul_ps(vt, _mm_load_ps(d + i)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(c, _mm_loadu_ps(x + i)));
+    }
+    __m128 shuf = _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(acc, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+#elif defined(REAL8_RESAMPLE_NEON)
+    const float32x4_t vt = vdupq_n_f32(t);
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (int i = 0; i < AudioResampler::TAPS; i += 4) {
+        float32x4_t c = vmlaq_f32(vld1q_f32(k + i), vt, vld1q_f32(d + i));
+        acc = vmlaq_f32(acc, c, vld1q_f32(x + i));
+    }
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t sum2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+#endif
+#else
+    float acc = 0.0f;
+    for (int i = 0; i < AudioResampler::TAPS; i++) {
+        acc += (k[i] + t * d[i]) * x[i];
+    }
+    return acc;
+#endif
+}
+
+void AudioResampler::configure(int in_rate_num, int in_rate_den, int out_rate) {
+    if (in_rate_num <= 0 || in_rate_den <= 0 || out_rate <= 0) return;
+
+    base_step = ((uint64_t)in_rate_num << 32) / ((uint64_t)in_rate_den * (uint64_t)out_rate);
+
+    // Cut off just below the lower of the two Nyquist frequencies.
+    const double in_rate = (double)in_rate_num / (double)in_rate_den;
+    const double cutoff = 0.90 * std::min(1.0, (double)out_rate / in_rate);
+    const double half = (double)TAPS * 0.5;
+    const double pi = 3.14159265358979323846;
+
+    // One extra row so kernel_delta of the last phase has a neighbour.
+    std::vector<float> rows((size_t)(PHASES + 1) * TAPS);
+    for (int p = 0; p <= PHASES; p++) {
+        const double frac = (double)p / (double)PHASES;
+        double sum = 0.0;
+        for (int j = 0; j < TAPS; j++) {
+            // Tap j sits at hist[idx + j]; the output lies frac past tap TAPS/2 - 1.
+            double x = (double)(j - (TAPS / 2 - 1)) - frac;
+            double s = (x == 0.0) ? 1.0 : sin(pi * cutoff * x) / (pi * cutoff * x);
+            double w = 0.0;
+            if (fabs(x) < half) {
+                double a = pi * x / half;
+                w = 0.42 + 0.5 * cos(a) + 0.08 * cos(2.0 * a); // Blackman
+            }
+            double v = s * w;
+            rows[p * TAPS + j] = (float)v;
+            sum += v;
+        }
+        // Unity gain at DC for every phase.
+        if (sum != 0.0) {
+            for (int j = 0; j < TAPS; j++) rows[p * TAPS + j] = (float)(rows[p * TAPS + j] / sum);
+        }
+    }
+    for (int p = 0; p < PHASES; p++) {
+        for (int j = 0; j < TAPS; j++) {
+            kernel[p * TAPS + j] = rows[p * TAPS + j];
+            kernel_delta[p * TAPS + j] = rows[(p + 1) * TAPS + j] - rows[p * TAPS + j];
+        }
+    }
+
+    setRateAdjust(rate_adjust);
+    reset();
+}
+
+void AudioResampler::reset() {
+    // Prime with silence so the first output is centred on the first input.
+    memset(hist, 0, sizeof(hist));
+    hist_count = TAPS - 1;
+    pos = 0;
+}
+
+void AudioResampler::setRateAdjust(double ratio) {
+    if (!(ratio > 0.5 && ratio < 2.0)) ratio = 1.0;
+    rate_adjust = ratio;
+    step = (uint64_t)((double)base_step / ratio);
+    if (step == 0) step = 1;
+}
+
+int AudioResampler::maxOutput(int in_count) const {
+    if (step == 0) return 0;
+    uint64_t span = ((uint64_t)(in_count + TAPS) << 32);
+    return (int)(span / step) + 2;
+}
+
+int AudioResampler::process(const int16_t* in, int in_count, int16_t* out, int out_capacity, int* in_used) {
+    if (in_used) *in_used = 0;
+    if (step == 0) return 0;
+    static constexpr float kInScale = 1.0f / 32768.0f;
+    const int in_total = in_count;
+    int produced = 0;
+    bool full = false;
+
+    // Also runs with no new input, to drain what an earlier full call left in hist.
+    for (;;) {
+        int take = std::min(in_count, (int)(TAPS + HIST_INPUT) - hist_count);
+        for (int i = 0; i < take; i++) hist[hist_count + i] = (float)in[i] * kInScale;
+        hist_count += take;
+        in += take;
+        in_count -= take;
+
+        while ((int)(pos >> 32) + TAPS <= hist_count) {
+            if (produced >= out_capacity) { full = true; break; } // resume here next call
+            int idx = (int)(pos >> 32);
+            uint32_t frac = (uint32_t)pos;
+            int phase = (int)(frac >> 24);
+            float t = (float)(frac & 0x00FFFFFFu) * (1.0f / 16777216.0f);
+            float v = resample_dot(kernel + phase * TAPS, kernel_delta + phase * TAPS, t, hist + idx);
+            pos += step;
+
+            int s = (int)lrintf(v * 32767.0f);
+            if (s > 32767) s = 32767;
+            if (s < -32768) s = -32768;
+            out[produced++] = (int16_t)s;
+        }
+
+        // Slide the window down, keeping the taps still needed.
+        int consumed = (int)(pos >> 32);
+        if (consumed > 0) {
+            memmove(hist, hist + consumed, (size_t)(hist_count - consumed) * sizeof(float));
+            hist_count -= consumed;
+            pos -= (uint64_t)consumed << 32;
+        }
+        if (full || in_count == 0) break;
+    }
+    if (in_used) *in_used = in_total - in_count;
+    return produced;
+}
+
+void AudioEngine::setOutputRate(int hz) {
+    if (hz < 0) hz = 0;
+    if (hz == output_rate) return;
+    output_rate = hz;
+
+    // An exact match with the mixer rate stays on the bit-identical direct path.
+    resampling = (hz > 0) && ((int64_t)hz * SAMPLE_RATE_DEN != (int64_t)SAMPLE_RATE_NUM);
+    if (resampling) {
+        resampler.rate_adjust = 1.0;
+        resampler.configure(SAMPLE_RATE_NUM, SAMPLE_RATE_DEN, hz);
+    }
+    flushOutputQueues();
+}
+#endif
+
 // --------------------------------------------------------------------------
 // AUTO-MUTE (MUSIC==0 && SFX==0)
 // --------------------------------------------------------------------------
@@ -196,6 +441,9 @@ void AudioEngine::flushOutputQueues() {
     last_mixed_sample = 0.0f;
     last_audio_ms = 0;
     gen_ms_max = 0;
+#if !defined(__GBA__)
+    if (resampling) resampler.reset();
+#endif
     // Do NOT reset sequencer/channel state here; we want playback to resume
     // where it left off when unmuted.
 }
@@ -203,7 +451,7 @@ void AudioEngine::flushOutputQueues() {
 void AudioEngine::updateVolumeMute() {
     // Automatic hard gate: when both master volumes are 0, stop all audio work.
     bool want = false;
-    if (vm) {
+    if (vm && !offline_render) {
         want = (vm->volume_music <= 0) && (vm->volume_sfx <= 0);
     }
 
@@ -506,74 +754,65 @@ void AudioEngine::run_tick() {
 // MAIN GENERATION LOOP
 // --------------------------------------------------------------------------
 
-void AudioEngine::generateSamples(int16_t* out_buffer, int count) {
-    // Keep the auto-mute gate in sync even when generateSamples() is called
-    // directly (e.g. libretro path).
-    updateVolumeMute();
-
-    if (isMuted()) {
-        memset(out_buffer, 0, count * sizeof(int16_t));
-        return;
+void AudioEngine::render_channel(int c, float* mix, int n, float music_master, float sfx_master) {
+    Channel &ch = channels[c];
+    if (ch.sfx_id == -1) return;
+
+    // Get Note Data
+    uint8_t *sfx_data = vm->sfx_ram + (ch.sfx_id * 68);
+    int row_idx = (ch.last_note_idx < 0) ? 0 : ch.last_note_idx; // Use correct note index for playback
+    int addr = row_idx * 2;
+    uint8_t b1 = sfx_data[addr+1];
+    int waveform = (b1 >> 5) & 0x7;
+    int pitch_key = sfx_data[addr] & 0x3F;
+    
+    // --- FX PROCESSING ---
+    // Everything except vibrato only changes on ticks, so it is constant
+    // across the segment.
+    float pitch = ch.current_pitch_val;
+    float vol = (float)ch.current_vol / 7.0f;
+    
+    float progress = 0.0f;
+    if (ch.speed > 0) progress = 1.0f - ((float)ch.tick_counter / (float)ch.speed);
+
+    switch(ch.effect) {
+        case 1: // Slide
+            pitch = ch.slide_start_pitch + (float(pitch_key) - ch.slide_start_pitch) * progress;
+            break;
+        case 3: // Drop
+            pitch = ch.slide_start_pitch * (1.0f - progress); 
+            break;
+        case 4: // Fade In
+            vol *= progress;
+            break;
+        case 5: // Fade Out
+            vol *= (1.0f - progress);
+            break;
     }
 
-    for (int i = 0; i < count; i++) {
-        
-        // --- 1. SEQUENCER UPDATE ---
-        samples_per_tick_accumulator += 1.0f;
-        while (samples_per_tick_accumulator >= kSamplesPerTick) {
-            samples_per_tick_accumulator -= kSamplesPerTick;
-            run_tick();
-        }
-
-        float mixed_sample = 0.0f;
+    if (ch.is_music) {
+        vol *= (0.6f * music_master); 
+    } else {
+        vol *= sfx_master;
+    }
 
-        // --- 2. SYNTHESIZE CHANNELS ---
-        for (int c = 0; c < CHANNELS; c++) {
-            Channel &ch = channels[c];
-            if (ch.sfx_id == -1) continue;
-
-            // Get Note Data
-            uint8_t *sfx_data = vm->sfx_ram + (ch.sfx_id * 68);
-            int row_idx = (ch.last_note_idx < 0) ? 0 : ch.last_note_idx; // Use correct note index for playback
-            int addr = row_idx * 2;
-            uint8_t b1 = sfx_data[addr+1];
-            int waveform = (b1 >> 5) & 0x7;
-            int pitch_key = sfx_data[addr] & 0x3F;
-            
-            // --- FX PROCESSING ---
-            float pitch = ch.current_pitch_val;
-            float vol = (float)ch.current_vol / 7.0f;
-            
-            float progress = 0.0f;
-            if (ch.speed > 0) progress = 1.0f - ((float)ch.tick_counter / (float)ch.speed);
-
-            switch(ch.effect) {
-                case 1: // Slide
-                    pitch = ch.slide_start_pitch + (float(pitch_key) - ch.slide_start_pitch) * progress;
-                    break;
-                case 2: // Vibrato
-                    ch.vib_phase += g_vibPhaseStep;
-                    if (ch.vib_phase >= 1.0f) ch.vib_phase -= 1.0f;
-                    {
-                        int vib_idx = (int)(ch.vib_phase * kVibLutSize) & kVibLutMask;
-                        float vib = (float)g_vibSinLut[vib_idx] * kVibLutScale;
-                        pitch += vib * kVibAmp;
-                    }
-                    break;
-                case 3: // Drop
-                    pitch = ch.slide_start_pitch * (1.0f - progress); 
-                    break;
-                case 4: // Fade In
-                    vol *= progress;
-                    break;
-                case 5: // Fade Out
-                    vol *= (1.0f - progress);
-                    break;
+    const bool audible = (channel_mask & (1 << c)) != 0;
+
+    // --- WAVEFORM GENERATION ---
+    if (waveform > 7 || ch.effect == 2) {
+        // Vibrato and custom instruments vary per sample.
+        for (int j = 0; j < n; j++) {
+            float p = pitch;
+            if (ch.effect == 2) { // Vibrato
+                ch.vib_phase += g_vibPhaseStep;
+                if (ch.vib_phase >= 1.0f) ch.vib_phase -= 1.0f;
+                int vib_idx = (int)(ch.vib_phase * kVibLutSize) & kVibLutMask;
+                float vib = (float)g_vibSinLut[vib_idx] * kVibLutScale;
+                p += vib * kVibAmp;
             }
 
-            // --- WAVEFORM GENERATION ---
             float sample = 0.0f;
-            float freq = note_to_freq(pitch);
+            float freq = note_to_freq(p);
 
             if (waveform > 7) { 
                 // --- CUSTOM INSTRUMENT (8-15) ---
@@ -610,35 +849,104 @@ void AudioEngine::generateSamples(int16_t* out_buffer, int count) {
                 sample = get_sample_for_state(ch, waveform, freq);
             }
 
-            if (ch.is_music) {
-                float music_master = (float)vm->volume_music / 10.0f;
-                vol *= (0.6f * music_master); 
-            } else {
-                float sfx_master = (float)vm->volume_sfx / 10.0f;
-                vol *= sfx_master;
-            }
+            if (audible) mix[j] += sample * vol;
+        }
+        return;
+    }
 
-            mixed_sample += sample * vol;
+    // --- STANDARD INSTRUMENT (0-7), fixed pitch ---
+    const float dt = note_to_freq(pitch) * kInvSampleRate;
+    switch (waveform) {
+        case 0: render_tone<osc_tri_unit>(ch, dt, vol, mix, n, audible); break;
+        case 1: render_tone<osc_tilted_saw_unit>(ch, dt, vol, mix, n, audible); break;
+        case 2: render_tone<osc_saw_unit>(ch, dt, vol, mix, n, audible); break;
+        case 3: render_tone<osc_square_unit>(ch, dt, vol, mix, n, audible); break;
+        case 4: render_tone<osc_pulse_unit>(ch, dt, vol, mix, n, audible); break;
+        case 5: render_tone<osc_organ>(ch, dt, vol, mix, n, audible); break;
+        case 6: render_noise(ch, dt, vol, mix, n, audible); break;
+        case 7: render_tone<osc_phaser>(ch, dt, vol, mix, n, audible); break;
+    }
+}
+
+void AudioEngine::generateSamples(int16_t* out_buffer, int count) {
+    // Keep the auto-mute gate in sync even when generateSamples() is called
+    // directly (e.g. libretro path).
+    updateVolumeMute();
+
+    if (isMuted()) {
+        memset(out_buffer, 0, count * sizeof(int16_t));
+        return;
+    }
+
+    const float music_master = offline_render ? 1.0f : (float)vm->volume_music / 10.0f;
+    const float sfx_master = offline_render ? 1.0f : (float)vm->volume_sfx / 10.0f;
+
+    // Channels are rendered one at a time over segments that contain no
+    // sequencer tick, then summed in channel order (same float ops as the
+    // old per-sample loop, so output is bit-identical).
+    float mix[kMixSegment];
+
+    int i = 0;
+    while (i < count) {
+        
+        // --- 1. SEQUENCER UPDATE ---
+        samples_per_tick_accumulator += 1.0f;
+        while (samples_per_tick_accumulator >= kSamplesPerTick) {
+            samples_per_tick_accumulator -= kSamplesPerTick;
+            run_tick();
         }
 
-        // --- 3. HARDWARE DISTORTION ---
-        if (vm->hwState.distort > 0) {
-             float dist_val = mixed_sample * 0.5f; 
-             int16_t d = (int16_t)(dist_val * 32767.0f);
-             d = (d / 0x1000) * 0x1249; 
-             mixed_sample = (float)d / 32767.0f;
+        // Extend the segment over the following samples that reach no tick.
+        int n = 1;
+        const int limit = std::min(count - i, kMixSegment);
+        while (n < limit && samples_per_tick_accumulator + 1.0f < kSamplesPerTick) {
+            samples_per_tick_accumulator += 1.0f;
+            n++;
+        }
+
+        // --- 2. SYNTHESIZE CHANNELS ---
+        for (int j = 0; j < n; j++) mix[j] = 0.0f;
+        for (int c = 0; c < CHANNELS; c++) {
+            render_channel(c, mix, n, music_master, sfx_master);
         }
 
-        // --- 4. OUTPUT ---
-        float out = mixed_sample * 0.5f; 
-        if (out < -1.0f) out = -1.0f; else if (out > 1.0f) out = 1.0f;
-        out_buffer[i] = (int16_t)(out * 32767.0f);
+        for (int j = 0; j < n; j++) {
+            float mixed_sample = mix[j];
+
+            // --- 3. HARDWARE DISTORTION ---
+            if (!offline_render && vm->hwState.distort > 0) {
+                 float dist_val = mixed_sample * 0.5f; 
+                 int16_t d = (int16_t)(dist_val * 32767.0f);
+                 d = (d / 0x1000) * 0x1249; 
+                 mixed_sample = (float)d / 32767.0f;
+            }
+
+            // --- 4. OUTPUT ---
+            float out = mixed_sample * 0.5f; 
+            if (out < -1.0f) out = -1.0f; else if (out > 1.0f) out = 1.0f;
+            out_buffer[i + j] = (int16_t)(out * 32767.0f);
+        }
+        i += n;
     }
 }
 
 void AudioEngine::update(IReal8Host *host) {
     if (!host) return;
 
+#if !defined(__GBA__)
+    setOutputRate(host->getAudioOutputRate());
+    if (resampling) {
+        // Dynamic rate control: stretch output slightly while the host queue
+        // sits away from half full, so the audio clock never drifts off the
+        // frame clock.
+        float fill = host->getAudioBufferFill();
+        if (fill >= 0.0f) {
+            if (fill > 1.0f) fill = 1.0f;
+            resampler.setRateAdjust(1.0 + (1.0 - 2.0 * (double)fill) * DRC_MAX_DELTA);
+        }
+    }
+#endif
+
     unsigned long now_ms = host->getMillis();
     if (last_audio_ms == 0) {
         last_audio_ms = now_ms;
@@ -686,11 +994,31 @@ void AudioEngine::update(IReal8Host *host) {
         int gen = gen_total;
         if (gen > 2048) gen = 2048;
         if (gen > max_chunk) gen = max_chunk;
+#if !defined(__GBA__)
+        if (resampling) {
+            while (gen > 1 && resampler.maxOutput(gen) > RESAMPLE_OUT_SAMPLES) gen >>= 1;
+        }
+#endif
         unsigned long gen_start = host->getMillis();
         generateSamples(buffer, gen);
         unsigned long gen_end = host->getMillis();
         unsigned long gen_ms = gen_end - gen_start;
         if (gen_ms > gen_ms_max) gen_ms_max = gen_ms;
+#if !defined(__GBA__)
+        if (resampling) {
+            // A full resample_buffer leaves input behind; feed it until all is taken.
+            const int16_t* src = buffer;
+            int left = gen;
+            for (;;) {
+                int used = 0;
+                int n = resampler.process(src, left, resample_buffer, RESAMPLE_OUT_SAMPLES, &used);
+                fifo_write(resample_buffer, n);
+                src += used;
+                left -= used;
+                if (n < RESAMPLE_OUT_SAMPLES && left == 0) break;
+            }
+        } else
+#endif
         fifo_write(buffer, gen);
         gen_total -= gen;
     }
@@ -732,6 +1060,131 @@ void AudioEngine::setState(const AudioStateSnapshot& s) {
     music_ticks_on_pattern = s.music_ticks_on_pattern;
 }
 
+// --------------------------------------------------------------------------
+// COMPACT STATE
+// --------------------------------------------------------------------------
+
+namespace {
+struct StateWriter {
+    uint8_t* p;
+    void u8(uint32_t v) { *p++ = (uint8_t)v; }
+    void i8(int v) { *p++ = (uint8_t)(int8_t)v; }
+    void u16(uint32_t v) { u8(v); u8(v >> 8); }
+    void u32(uint32_t v) { u16(v); u16(v >> 16); }
+    void f32(float v) { uint32_t bits; memcpy(&bits, &v, 4); u32(bits); }
+};
+
+struct StateReader {
+    const uint8_t* p;
+    uint32_t u8() { return *p++; }
+    int i8() { return (int8_t)*p++; }
+    uint32_t u16() { uint32_t v = u8(); return v | (u8() << 8); }
+    uint32_t u32() { uint32_t v = u16(); return v | (u16() << 16); }
+    float f32() { uint32_t bits = u32(); float v; memcpy(&v, &bits, 4); return v; }
+};
+
+// Noise output is always -1, 0 or +1.
+inline int noiseToByte(float v) { return (v > 0.0f) ? 1 : ((v < 0.0f) ? -1 : 0); }
+}
+
+size_t AudioEngine::serializeState(uint8_t* out, size_t capacity) const {
+    if (!out || capacity < STATE_SIZE) return 0;
+    StateWriter w{out};
+
+    w.u32(STATE_MAGIC);
+    w.u16(STATE_VERSION);
+    w.u16((uint32_t)(STATE_SIZE - STATE_HEADER_SIZE));
+
+    for (int i = 0; i < CHANNELS; i++) {
+        const Channel& c = channels[i];
+        // Note, volume and pitch values are whole numbers set on ticks.
+        w.i8(c.sfx_id);
+        w.i8(c.last_note_idx);
+        w.f32(c.phi);
+        w.u16(c.lfsr);
+        w.i8(noiseToByte(c.noise_sample));
+        w.u8((uint32_t)c.current_vol);
+        w.u8((uint32_t)c.current_pitch_val);
+        w.u8((uint32_t)c.slide_start_pitch);
+        w.f32(c.vib_phase);
+        w.u8(c.loop_start);
+        w.u8(c.loop_end);
+        w.i8(c.stop_row);
+        w.u8(c.tick_counter);
+        w.u8(c.speed);
+        w.u8(c.row);
+        w.u8((c.loop_active ? 1u : 0u) | (c.is_music ? 2u : 0u));
+        w.u8(c.effect);
+        // Custom instrument voice
+        w.i8(c.child.sfx_id);
+        w.f32(c.child.offset);
+        w.f32(c.child.phi);
+        w.u16(c.child.lfsr);
+        w.i8(noiseToByte(c.child.noise_sample));
+    }
+
+    w.i8(music_pattern);
+    w.u16(music_tick_timer);
+    w.u8(music_speed);
+    w.i8(music_loop_start);
+    w.u8(music_mask);
+    w.u8(music_playing ? 1 : 0);
+    w.u32((uint32_t)music_patterns_played);
+    w.u16(music_ticks_on_pattern);
+    w.f32(samples_per_tick_accumulator);
+
+    return (size_t)(w.p - out);
+}
+
+bool AudioEngine::unserializeState(const uint8_t* in, size_t size) {
+    if (!in || size < STATE_SIZE) return false;
+    StateReader r{in};
+
+    if (r.u32() != STATE_MAGIC) return false;
+    uint32_t version = r.u16();
+    uint32_t payload = r.u16();
+    if (version != STATE_VERSION || payload != STATE_SIZE - STATE_HEADER_SIZE) return false;
+
+    for (int i = 0; i < CHANNELS; i++) {
+        Channel& c = channels[i];
+        c.sfx_id = r.i8();
+        c.last_note_idx = r.i8();
+        c.phi = r.f32();
+        c.lfsr = r.u16();
+        c.noise_sample = (float)r.i8();
+        c.current_vol = (float)r.u8();
+        c.current_pitch_val = (float)r.u8();
+        c.slide_start_pitch = (float)r.u8();
+        c.vib_phase = r.f32();
+        c.loop_start = r.u8();
+        c.loop_end = r.u8();
+        c.stop_row = r.i8();
+        c.tick_counter = r.u8();
+        c.speed = r.u8();
+        c.row = r.u8();
+        uint32_t flags = r.u8();
+        c.loop_active = (flags & 1) != 0;
+        c.is_music = (flags & 2) != 0;
+        c.effect = r.u8();
+        c.child.sfx_id = r.i8();
+        c.child.offset = r.f32();
+        c.child.phi = r.f32();
+        c.child.lfsr = r.u16();
+        c.child.noise_sample = (float)r.i8();
+    }
+
+    music_pattern = r.i8();
+    music_tick_timer = r.u16();
+    music_speed = r.u8();
+    music_loop_start = r.i8();
+    music_mask = (uint8_t)r.u8();
+    music_playing = r.u8() != 0;
+    music_patterns_played = (int)r.u32();
+    music_ticks_on_pattern = r.u16();
+    samples_per_tick_accumulator = r.f32();
+    return true;
+}
+
 static const AudioEngine::MixerTickSnap* get_last_snap(const AudioEngine &audio) {
     if (!audio.snaps_ready) return nullptr;
     int idx = (audio.snap_w - 1) & (AudioEngine::SNAP_COUNT - 1);
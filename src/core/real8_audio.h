@@ -60,6 +60,42 @@ struct Channel : public ChannelState
     float crossfade_progress = 0.0f;
 };
 
+#if !defined(__GBA__)
+// Polyphase windowed-sinc resampler. Converts the mixer's mono S16 stream to
+// the host device rate so the OS/driver doesn't have to. The ratio can be
+// nudged at runtime (dynamic rate control) to keep the host queue level.
+struct AudioResampler
+{
+    static constexpr int TAPS = 16;       // kernel length (multiple of 4 for SIMD)
+    static constexpr int PHASES = 256;    // sub-sample kernel positions
+    static constexpr int HIST_INPUT = 512; // input samples buffered per pass
+
+    alignas(16) float kernel[PHASES * TAPS];
+    alignas(16) float kernel_delta[PHASES * TAPS]; // kernel[p+1] - kernel[p]
+    alignas(16) float hist[TAPS + HIST_INPUT];
+    int hist_count = 0;
+
+    uint64_t base_step = 0; // 32.32 input samples per output sample
+    uint64_t step = 0;      // base_step with rate adjust applied
+    uint64_t pos = 0;       // 32.32 read position into hist
+    double rate_adjust = 1.0;
+
+    void configure(int in_rate_num, int in_rate_den, int out_rate);
+    void reset();
+
+    // ratio > 1.0 produces more output per input (host queue running low).
+    void setRateAdjust(double ratio);
+
+    // Upper bound of output samples produced by process() for in_count inputs.
+    int maxOutput(int in_count) const;
+
+    // Returns the number of samples written to out. Stops once out_capacity
+    // samples are written: *in_used tells how much of in was taken, and the
+    // output still pending in the window comes first on the next call.
+    int process(const int16_t* in, int in_count, int16_t* out, int out_capacity, int* in_used = nullptr);
+};
+#endif
+
 struct AudioEngine
 {
     // "muted" is reserved for an explicit/host-driven mute (if any).
@@ -67,6 +103,11 @@ struct AudioEngine
     // master volumes are set to 0 in the in-game menu.
     bool muted = false;
     bool volume_mute = false;
+    // Offline rendering (Real8Tools::ExportAudio): full volume regardless of
+    // the menu sliders, no hardware distortion, and only the channels set in
+    // channel_mask reach the mix (the others still run, so timing is shared).
+    bool offline_render = false;
+    uint8_t channel_mask = 0x0f;
     static const int CHANNELS = 4;
     #if defined(__3DS__)
     static constexpr int SAMPLE_RATE_NUM = 55125;
@@ -137,11 +178,24 @@ struct AudioEngine
 
     // Main Update
     void update(IReal8Host *host);
+
+#if !defined(__GBA__)
+    // Host output rate. 0 (or the mixer rate) bypasses the resampler.
+    static constexpr int RESAMPLE_OUT_SAMPLES = 4096;
+    static constexpr double DRC_MAX_DELTA = 0.005;
+    int output_rate = 0;
+    bool resampling = false;
+    AudioResampler resampler;
+    int16_t resample_buffer[RESAMPLE_OUT_SAMPLES];
+
+    void setOutputRate(int hz);
+#endif
     
     // Internal Tickers
     void run_tick();           
     void update_channel_tick(int ch_idx); 
     void update_music_tick(); 
+    void render_channel(int ch_idx, float* mix, int count, float music_master, float sfx_master);
 
     // Updated Signature
     float get_waveform_sample(int waveform, float phi, ChannelState &state, float freq_mult);
@@ -178,6 +232,20 @@ struct AudioEngine
     AudioStateSnapshot getState();
     void setState(const AudioStateSnapshot& s);
 
+    // Compact savestate: little-endian, versioned, live fields only, so it is
+    // portable between builds and cheap enough for rewind/run-ahead.
+    static constexpr uint32_t STATE_MAGIC = 0x53413852; // "R8AS"
+    static constexpr uint16_t STATE_VERSION = 1;
+    static constexpr size_t STATE_HEADER_SIZE = 8;      // magic, version, payload size
+    static constexpr size_t STATE_CHANNEL_SIZE = 36;
+    static constexpr size_t STATE_MUSIC_SIZE = 17;
+    static constexpr size_t STATE_SIZE = STATE_HEADER_SIZE + CHANNELS * STATE_CHANNEL_SIZE + STATE_MUSIC_SIZE;
+
+    // Returns bytes written (STATE_SIZE), or 0 if out is too small.
+    size_t serializeState(uint8_t* out, size_t capacity) const;
+    // Returns false (state untouched) on a bad magic, version or size.
+    bool unserializeState(const uint8_t* in, size_t size);
+
     // 3DS / GBA
 #if defined(__GBA__)
     static constexpr int OUT_BLOCK_SAMPLES = 368;
@@ -14,8 +14,6 @@
 #include <vector>
 #include <unordered_map>
 
-#include "../../lib/z8lua/trigtables.h"
-
 // z8lua is based on Lua 5.2, which lacks the Lua 5.3 function 'lua_isyieldable'.
 // We define it here to always return 1 (true), allowing the VM to yield.
 #ifndef lua_isyieldable
@@ -32,9 +30,6 @@ int debug_spr_count = 0;
 int debug_print_count = 0;
 int debug_cls_count = 0;
 
-// CONSTANT: Tau is 2*PI
-static const float TAU = 6.28318530718f;
-
 #if defined(__GBA__)
 #define REAL8_EWRAM __attribute__((section(".ewram")))
 #else
@@ -58,31 +53,6 @@ static const float TAU = 6.28318530718f;
 #endif
 static Real8VM *g_vm = nullptr;
 
-static constexpr int kTrigLutSize = 1024;
-static constexpr int kTrigLutMask = kTrigLutSize - 1;
-static constexpr int kTrigLutQuarter = kTrigLutSize / 4;
-static int16_t g_sinLut[kTrigLutSize] REAL8_EWRAM;
-static bool g_trigLutReady = false;
-
-static void initTrigLut()
-{
-    if (g_trigLutReady)
-        return;
-    const float step = TAU / (float)kTrigLutSize;
-    for (int i = 0; i < kTrigLutSize; ++i)
-    {
-        float angle = (float)i * step;
-        g_sinLut[i] = (int16_t)(sinf(angle) * 32767.0f);
-    }
-    g_trigLutReady = true;
-}
-
-static inline int trig_lut_index(lua_Number a)
-{
-    uint32_t frac = (uint32_t)a.bits() & 0xffff;
-    return (int)((frac * kTrigLutSize) >> 16) & kTrigLutMask;
-}
-
 static void reg(lua_State *L, const char *n, lua_CFunction f)
 {
     lua_pushcfunction(L, f);
@@ -113,19 +83,29 @@ static void vm_sync_ram(Real8VM *vm, uint32_t start_addr, int length);
 // Forward declaration for helper used before definition
 static uint8_t read_mapped_byte(Real8VM *vm, uint32_t addr);
 
-// Fast conversion used by most API calls (avoid heavy math on GBA)
-static inline int to_int_floor(lua_State *L, int idx)
+// Argument accessors used by most API calls. One call reads the raw fix32
+// bits straight off the Lua stack: no lua_Number temporaries, no separate
+// isboolean/isnil probes. Booleans count as 0/1 and nil or a missing
+// argument yields def.
+static inline int32_t to_pico_fixed(lua_State *L, int idx, int32_t def = 0)
 {
-    if (lua_isboolean(L, idx)) {
-        return lua_toboolean(L, idx) ? 1 : 0;
-    }
-    lua_Number v = lua_tonumber(L, idx);
-    int32_t bits = v.bits();
-    int32_t i = bits >> 16;
-    if (bits < 0 && (bits & 0xffff)) {
-        --i;
-    }
-    return (int)i;
+    int32_t bits = def;
+    lua_tofix32bits(L, idx, &bits);
+    return bits;
+}
+
+// Integer part, floored like PICO-8 (the shift rounds toward -inf)
+static inline int to_int_floor(lua_State *L, int idx, int def = 0)
+{
+    int32_t bits;
+    return lua_tofix32bits(L, idx, &bits) ? (int)(bits >> 16) : def;
+}
+
+// Optional draw color: low nibble of the argument, else the current pen
+static inline int to_color(lua_State *L, int idx, int pen)
+{
+    int32_t bits;
+    return lua_tofix32bits(L, idx, &bits) ? (int)(bits >> 16) & 0x0F : pen;
 }
 
 static inline int to_int(lua_State *L, int idx)
@@ -150,10 +130,10 @@ static int l_stat(lua_State *L)
     // --- MEMORY & CPU ---
     case 0: // Memory Usage (KB)
     {
-        lua_gc(L, LUA_GCCOLLECT, 0);
-        int kbytes = lua_gc(L, LUA_GCCOUNT, 0);
-        int bytes = lua_gc(L, LUA_GCCOUNTB, 0);
-        lua_pushnumber(L, (double)kbytes + ((double)bytes / 1024.0));
+        // Live size tracked by the collector; a full collect here would
+        // cost a frame spike every time a HUD polls it.
+        size_t bytes = vm ? vm->luaLiveBytes() : 0;
+        lua_pushnumber(L, (double)bytes / 1024.0);
         return 1;
     }
     case 1: // CPU Usage (0.0 - 1.0)
@@ -750,52 +730,22 @@ std::string transpile_pico8(const std::string& src) {
     return out;
 }
 
+// sin/cos/atan2/sqrt are the bit-exact fix32 kernels shared with z8lua
 static int l_sin(lua_State *L)
 {
-    // z8lua does not strictly replace math functions unless using their lib.
-    // We keep the inverted Y logic here.
-    initTrigLut();
-    lua_Number a = lua_tonumber(L, 1);
-    int idx = trig_lut_index(a);
-    int32_t bits = (int32_t)g_sinLut[idx] << 1;
-    lua_pushnumber(L, lua_Number::frombits(-bits));
+    lua_pushnumber(L, lua_Number::sin(lua_tonumber(L, 1)));
     return 1;
 }
 
 static int l_cos(lua_State *L)
 {
-    initTrigLut();
-    lua_Number a = lua_tonumber(L, 1);
-    int idx = (trig_lut_index(a) + kTrigLutQuarter) & kTrigLutMask;
-    int32_t bits = (int32_t)g_sinLut[idx] << 1;
-    lua_pushnumber(L, lua_Number::frombits(bits));
+    lua_pushnumber(L, lua_Number::cos(lua_tonumber(L, 1)));
     return 1;
 }
 
-static inline lua_Number pico8_atan2_fixed(lua_Number x, lua_Number y)
-{
-    int32_t bits = 0x4000;
-    if (x) {
-        int64_t xb = x.bits();
-        int64_t yb = y.bits();
-        int64_t q = (std::abs(yb) << 16) / std::abs(xb);
-        if (q > 0x10000) {
-            bits -= atantable[(int64_t(1) << 32) / q >> 5];
-        } else {
-            bits = atantable[q >> 5];
-        }
-    }
-    if (x.bits() < 0) bits = 0x8000 - bits;
-    if (y.bits() > 0) bits = -bits & 0xffff;
-    if (x && y.bits() == int32_t(0x80000000)) bits = -bits & 0xffff;
-    return lua_Number::frombits(bits);
-}
-
 static int l_atan2(lua_State *L)
 {
-    lua_Number x = lua_tonumber(L, 1);
-    lua_Number y = lua_tonumber(L, 2);
-    lua_pushnumber(L, pico8_atan2_fixed(x, y));
+    lua_pushnumber(L, lua_Number::atan2(lua_tonumber(L, 1), lua_tonumber(L, 2)));
     return 1;
 }
 
@@ -811,21 +761,6 @@ inline void fast_pset(Real8VM *vm, int x, int y, uint8_t c)
     }
 }
 
-// We can use standard lua_tointeger to get the raw representation for bitwise logic
-// if we assume standard PICO-8 behavior, but using the explicit conversion is safest
-// to avoid Lua 5.4 integer/float mix-ups in the C-API.
-
-static inline int32_t to_pico_fixed(lua_State *L, int idx)
-{
-    // z8lua treats 'true' as 1.0 (0x00010000) automatically in math,
-    // but explicit checking is safe.
-    if (lua_isboolean(L, idx))
-        return lua_toboolean(L, idx) ? 65536 : 0;
-
-    lua_Number v = lua_tonumber(L, idx);
-    return v.bits();
-}
-
 // Added boolean check. PICO-8 allows bitwise ops on booleans (True=1, False=0)
 static inline uint32_t l_mask(lua_State *L, int idx)
 {
@@ -1042,7 +977,14 @@ static int l_flip(lua_State *L)
         target_ms = 16;
 
     static unsigned long last_flip_time = 0;
-    long elapsed = (long)(now - last_flip_time);
+
+    // Carts that loop on flip() never return to runFrame; give the
+    // collector the time we would otherwise sleep through.
+    unsigned long gc_start = l_millis(L);
+    if (last_flip_time != 0) vm->stepIdleGC(last_flip_time, target_ms);
+    long gc_ms = (long)(l_millis(L) - gc_start);
+
+    long elapsed = (long)(now - last_flip_time) + gc_ms;
     long wait = target_ms - elapsed;
 
     if (wait > 0 && vm->host)
@@ -1065,17 +1007,7 @@ static int l_bnot(lua_State *L)
 
 static int l_sqrt(lua_State *L)
 {
-    int64_t root = 0;
-    int64_t x = int64_t(lua_tonumber(L, 1).bits()) << 16;
-    if (x > 0) {
-        for (int64_t a = int64_t(1) << 46; a; a >>= 2, root >>= 1) {
-            if (x >= a + root) {
-                x -= a + root;
-                root += a << 1;
-            }
-        }
-    }
-    lua_pushnumber(L, lua_Number::frombits((int32_t)root));
+    lua_pushnumber(L, lua_Number::sqrt(lua_tonumber(L, 1)));
     return 1;
 }
 
@@ -1136,7 +1068,7 @@ static int l_time(lua_State *L)
 static int l_atan(lua_State *L)
 {
     lua_Number x = lua_tonumber(L, 1);
-    lua_Number t = pico8_atan2_fixed(lua_Number::frombits(0x10000), x);
+    lua_Number t = lua_Number::atan2(lua_Number::frombits(0x10000), x);
     uint32_t bits = (uint32_t)t.bits() + 0x4000;
     bits &= 0xffff;
     lua_pushnumber(L, lua_Number::frombits((int32_t)bits));
@@ -1162,11 +1094,7 @@ static int IWRAM_BINDINGS_CODE l_pset(lua_State *L)
     auto *vm = get_vm(L);
     int x = to_int_floor(L, 1);
     int y = to_int_floor(L, 2);
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 3 && !lua_isnil(L, 3))
-    {
-        c = to_int_floor(L, 3) & 0x0F;
-    }
+    int c = to_color(L, 3, vm->gpu.getPen());
     vm->gpu.pset(x, y, (uint8_t)c);
     return 0;
 }
@@ -1206,11 +1134,7 @@ static int IWRAM_BINDINGS_CODE l_line(lua_State *L)
         y1 = to_int_floor(L, 4);
     }
 
-    int c = vm->gpu.getPen();
-    if (argc >= c_arg_idx && !lua_isnil(L, c_arg_idx))
-    {
-        c = to_int_floor(L, c_arg_idx) & 0x0F;
-    }
+    int c = to_color(L, c_arg_idx, vm->gpu.getPen());
 
     vm->gpu.line(x0, y0, x1, y1, (uint8_t)c);
 
@@ -1228,11 +1152,7 @@ static int IWRAM_BINDINGS_CODE l_rectfill(lua_State *L)
     int y0 = to_int_floor(L, 2);
     int x1 = to_int_floor(L, 3);
     int y1 = to_int_floor(L, 4);
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 5 && !lua_isnil(L, 5))
-    {
-        c = to_int_floor(L, 5) & 0x0F;
-    }
+    int c = to_color(L, 5, vm->gpu.getPen());
     vm->gpu.rectfill(x0, y0, x1, y1, (uint8_t)c);
     return 0;
 }
@@ -1244,11 +1164,7 @@ static int l_rect(lua_State *L)
     int y0 = to_int_floor(L, 2);
     int x1 = to_int_floor(L, 3);
     int y1 = to_int_floor(L, 4);
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 5 && !lua_isnil(L, 5))
-    {
-        c = to_int_floor(L, 5) & 0x0F;
-    }
+    int c = to_color(L, 5, vm->gpu.getPen());
     vm->gpu.rect(x0, y0, x1, y1, (uint8_t)c);
     return 0;
 }
@@ -1259,12 +1175,8 @@ static int l_rrectfill(lua_State *L)
     int y = to_int_floor(L, 2);
     int w = to_int_floor(L, 3);
     int h = to_int_floor(L, 4);
-    int r = (lua_gettop(L) >= 5 && !lua_isnil(L, 5)) ? to_int_floor(L, 5) : 0;
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 6 && !lua_isnil(L, 6))
-    {
-        c = to_int_floor(L, 6) & 0x0F;
-    }
+    int r = to_int_floor(L, 5);
+    int c = to_color(L, 6, vm->gpu.getPen());
     vm->gpu.rrectfill(x, y, w, h, r, (uint8_t)c);
     return 0;
 }
@@ -1275,12 +1187,8 @@ static int l_rrect(lua_State *L)
     int y = to_int_floor(L, 2);
     int w = to_int_floor(L, 3);
     int h = to_int_floor(L, 4);
-    int r = (lua_gettop(L) >= 5 && !lua_isnil(L, 5)) ? to_int_floor(L, 5) : 0;
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 6 && !lua_isnil(L, 6))
-    {
-        c = to_int_floor(L, 6) & 0x0F;
-    }
+    int r = to_int_floor(L, 5);
+    int c = to_color(L, 6, vm->gpu.getPen());
     vm->gpu.rrect(x, y, w, h, r, (uint8_t)c);
     return 0;
 }
@@ -2042,10 +1950,10 @@ static int l_print(lua_State *L)
 
 static int l_mid(lua_State *L)
 {
-    double x = luaL_optnumber(L, 1, 0.0);
-    double y = luaL_optnumber(L, 2, 0.0);
-    double z = luaL_optnumber(L, 3, 0.0);
-    lua_pushnumber(L, std::max(std::min(x, y), std::min(std::max(x, y), z)));
+    lua_Number x = lua_Number::frombits(to_pico_fixed(L, 1));
+    lua_Number y = lua_Number::frombits(to_pico_fixed(L, 2));
+    lua_Number z = lua_Number::frombits(to_pico_fixed(L, 3));
+    lua_pushnumber(L, lua_Number::max(lua_Number::min(x, y), lua_Number::min(lua_Number::max(x, y), z)));
     return 1;
 }
 
@@ -2690,11 +2598,7 @@ static int l_circ(lua_State *L)
     int cx = to_int_floor(L, 1);
     int cy = to_int_floor(L, 2);
     int r = to_int_floor(L, 3);
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 4 && !lua_isnil(L, 4))
-    {
-        c = to_int_floor(L, 4) & 0x0F;
-    }
+    int c = to_color(L, 4, vm->gpu.getPen());
     vm->gpu.circ(cx, cy, r, (uint8_t)c);
     return 0;
 }
@@ -2706,11 +2610,7 @@ static int l_circfill(lua_State *L)
     int cx = to_int_floor(L, 1);
     int cy = to_int_floor(L, 2);
     int r = to_int_floor(L, 3);
-    int c = vm->gpu.getPen();
-    if (lua_gettop(L) >= 4 && !lua_isnil(L, 4))
-    {
-        c = to_int_floor(L, 4) & 0x0F;
-    }
+    int c = to_color(L, 4, vm->gpu.getPen());
     vm->gpu.circfill(cx, cy, r, (uint8_t)c);
     return 0;
 }
@@ -2724,10 +2624,11 @@ static int l_tline(lua_State *L)
     int x1 = to_int_floor(L, 3);
     int y1 = to_int_floor(L, 4);
 
-    double mx = luaL_optnumber(L, 5, 0.0);
-    double my = luaL_optnumber(L, 6, 0.0);
-    double mdx = luaL_optnumber(L, 7, 0.0);
-    double mdy = luaL_optnumber(L, 8, 0.0);
+    // Map coordinates step in fix32, as on PICO-8
+    int32_t mx = to_pico_fixed(L, 5);
+    int32_t my = to_pico_fixed(L, 6);
+    const int32_t mdx = to_pico_fixed(L, 7);
+    const int32_t mdy = to_pico_fixed(L, 8);
 
     // Retrieve Transparency Mask from RAM (safe fallback if vm->ram is null)
     uint16_t palt_mask = (vm->ram) ? (vm->ram[0x5F5C] | (vm->ram[0x5F5D] << 8)) : 0x0001;
@@ -2738,8 +2639,8 @@ static int l_tline(lua_State *L)
 
     while (true)
     {
-        int tx = ((int)mx) & 127;
-        int ty = ((int)my) & 127;
+        int tx = (mx >> 16) & 127;
+        int ty = (my >> 16) & 127;
 
         uint8_t c = vm->gpu.sget(tx, ty);
 
@@ -2765,8 +2666,8 @@ static int l_tline(lua_State *L)
             y0 += sy;
         }
 
-        mx += mdx;
-        my += mdy;
+        mx = (int32_t)((uint32_t)mx + (uint32_t)mdx);
+        my = (int32_t)((uint32_t)my + (uint32_t)mdy);
     }
     return 0;
 }
@@ -3038,20 +2939,17 @@ static int IWRAM_BINDINGS_CODE l_spr(lua_State *L)
     int y = (int16_t)to_int_floor(L, 3);
 
     // PICO-8 accepts fractional w/h for spr() and treats them as partial sprite sizes.
-    double dw = luaL_optnumber(L, 4, 1.0);
-    double dh = luaL_optnumber(L, 5, 1.0);
+    int32_t dw = to_pico_fixed(L, 4, 0x10000);
+    int32_t dh = to_pico_fixed(L, 5, 0x10000);
     bool fx = lua_toboolean(L, 6), fy = lua_toboolean(L, 7);
 
-    const auto is_int = [](double v) { return std::fabs(v - std::round(v)) < 1e-6; };
-    if (is_int(dw) && is_int(dh)) {
-        int w = (int)std::round(dw);
-        int h = (int)std::round(dh);
-        vm->gpu.spr(n, x, y, w, h, fx, fy);
+    if (((dw | dh) & 0xffff) == 0) {
+        vm->gpu.spr(n, x, y, dw >> 16, dh >> 16, fx, fy);
         return 0;
     }
 
-    int sw = (int)std::floor(dw * 8.0 + 1e-6);
-    int sh = (int)std::floor(dh * 8.0 + 1e-6);
+    int sw = dw >> 13; // floor(w * 8)
+    int sh = dh >> 13;
     if (sw <= 0 || sh <= 0) return 0;
 
     int sx = (n % 16) * 8;
@@ -3073,8 +2971,8 @@ static int IWRAM_BINDINGS_CODE l_sspr(lua_State *L)
     int dy = to_int_floor(L, 6);
     
     // Optional scaling
-    int dw = (lua_gettop(L) >= 7 && !lua_isnil(L, 7)) ? to_int_floor(L, 7) : sw;
-    int dh = (lua_gettop(L) >= 8 && !lua_isnil(L, 8)) ? to_int_floor(L, 8) : sh;
+    int dw = to_int_floor(L, 7, sw);
+    int dh = to_int_floor(L, 8, sh);
     
     // Capture Flip Flags (Args 9 and 10)
     bool fx = (lua_gettop(L) >= 9) ? lua_toboolean(L, 9) : false;
@@ -3135,22 +3033,14 @@ static int IWRAM_BINDINGS_CODE l_map(lua_State *L)
 
     if (n > 0)
     {
-        if (!lua_isnil(L, 1))
-            mx = to_int_floor(L, 1);
-        if (n >= 2 && !lua_isnil(L, 2))
-            my = to_int_floor(L, 2);
-        if (n >= 3 && !lua_isnil(L, 3))
-            sx = to_int_floor(L, 3);
-        if (n >= 4 && !lua_isnil(L, 4))
-            sy = to_int_floor(L, 4);
-
-        // Critical Fix: Explicitly check nil to preserve defaults
-        if (n >= 5 && !lua_isnil(L, 5))
-            w = to_int_floor(L, 5);
-        if (n >= 6 && !lua_isnil(L, 6))
-            h = to_int_floor(L, 6);
-        if (n >= 7 && !lua_isnil(L, 7))
-            layer = to_int_floor(L, 7);
+        // nil keeps the default
+        mx = to_int_floor(L, 1, mx);
+        my = to_int_floor(L, 2, my);
+        sx = to_int_floor(L, 3, sx);
+        sy = to_int_floor(L, 4, sy);
+        w = to_int_floor(L, 5, w);
+        h = to_int_floor(L, 6, h);
+        layer = to_int_floor(L, 7, layer);
     }
 
     // PICO-8 treats layer bitmask 0 as "draw everything" usually,
@@ -3505,7 +3395,7 @@ static int l_peek4(lua_State *L)
     // PICO-8 uses 16.16 fixed point numbers. peek4 returns a standard Lua number.
     if (vm && vm->ram)
     {
-        int addr = (int)lua_tonumber(L, 1);
+        int addr = to_int_floor(L, 1);
         if (addr >= 0 && addr < 0x7FFC)
         {
             // Read 4 bytes as 16.16 fixed point
@@ -3513,7 +3403,7 @@ static int l_peek4(lua_State *L)
                         | (read_mapped_byte(vm, (uint32_t)addr + 1) << 8)
                         | (read_mapped_byte(vm, (uint32_t)addr + 2) << 16)
                         | (read_mapped_byte(vm, (uint32_t)addr + 3) << 24);
-            lua_pushnumber(L, (double)raw / 65536.0);
+            push_pico_fixed(L, raw);
             return 1;
         }
     }
@@ -3529,14 +3419,7 @@ static int l_poke4(lua_State *L)
     {
         int addr = to_int_floor(L, 1);
 
-        // Handle boolean explicitly for fixed point conversion
-        double val;
-        if (lua_isboolean(L, 2))
-            val = lua_toboolean(L, 2) ? 1.0 : 0.0;
-        else
-            val = lua_tonumber(L, 2);
-
-        int32_t fixed = (int32_t)(val * 65536.0);
+        int32_t fixed = to_pico_fixed(L, 2);
         if (addr >= 0 && addr < 0x7FFC)
         {
             write_mapped_byte(vm, addr, fixed & 0xFF);
@@ -3767,7 +3650,7 @@ static int l_rnd(lua_State *L)
 static int l_sub(lua_State *L)
 {
     size_t len;
-    const char *s = luaL_checklstring(L, 1, &len);
+    luaL_checklstring(L, 1, &len);
 
     // PICO-8 defaults: start=1, end=-1 (length)
     int start = (lua_gettop(L) >= 2 && !lua_isnil(L, 2)) ? to_int_floor(L, 2) : 1;
@@ -3791,7 +3674,7 @@ static int l_sub(lua_State *L)
     }
     else
     {
-        lua_pushlstring(L, s + start - 1, end - start + 1);
+        lua_pushsubstring(L, 1, start - 1, end - start + 1);
     }
     return 1;
 }
@@ -3818,193 +3701,175 @@ static int l_load_p8_file(lua_State *L) {
     return 1; // return chunk
 }
 
-static int internal_tonum(lua_State *L, int idx, int flags)
+// PICO-8 tonum() on a string: decimal through fix32::fromstr (no libc
+// parsing, same bits the literal would get), "0x" hex with up to four
+// fraction digits, "0b" binary. Flags: 0x1 reads hex without the prefix,
+// 0x2 reads a 32-bit integer and shifts it right 16 bits.
+static bool parse_tonum(const char *s_raw, size_t len, int flags, int32_t &bits)
 {
-    // 1. Handle Number (Identity)
-    if (lua_type(L, idx) == LUA_TNUMBER)
+    // Skip leading whitespace
+    size_t pos = 0;
+    while (pos < len && isspace((unsigned char)s_raw[pos]))
     {
-        lua_pushvalue(L, idx);
-        return 1;
+        pos++;
     }
 
-    // 2. Handle Boolean (PICO-8 returns 1 or 0)
-    if (lua_isboolean(L, idx))
+    // Empty or pure whitespace = nil; Lua strings end in a NUL, so one
+    // inside would cut the number short
+    size_t remaining = len - pos;
+    const char *s = s_raw + pos;
+    if (remaining == 0 || memchr(s, '\0', remaining))
     {
-        int val = lua_toboolean(L, idx);
-        lua_pushnumber(L, val ? 1.0 : 0.0);
-        return 1;
+        return false;
     }
 
-    // 3. Handle String
-    if (lua_isstring(L, idx))
-    {
-        size_t len;
-        const char *s_raw = lua_tolstring(L, idx, &len);
+    const char *p = s;
+    bool neg = false;
+    const char *digits = (*s == '+' || *s == '-') ? s + 1 : s;
+    bool is_hex = (flags & 1) || (digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'));
 
-        if (flags & 2)
-        {
-            if (len < 4)
-            {
-                lua_pushnil(L);
-                return 1;
-            }
-            uint32_t raw = (uint8_t)s_raw[0]
-                         | ((uint32_t)(uint8_t)s_raw[1] << 8)
-                         | ((uint32_t)(uint8_t)s_raw[2] << 16)
-                         | ((uint32_t)(uint8_t)s_raw[3] << 24);
-            push_pico_fixed(L, (int32_t)raw);
-            return 1;
+    if (flags & 2)
+    {
+        if (*p == '+' || *p == '-') {
+            neg = (*p == '-');
+            p++;
         }
-
-        // Skip leading whitespace
-        size_t pos = 0;
-        while (pos < len && isspace((unsigned char)s_raw[pos]))
-        {
-            pos++;
+        if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            is_hex = true;
+            p += 2;
         }
-
-        size_t remaining = len - pos;
-
-        // Empty or pure whitespace = nil
-        if (remaining == 0)
-        {
-            lua_pushnil(L);
-            return 1;
+        uint32_t raw = 0;
+        digits = p;
+        for (; is_hex ? isxdigit((unsigned char)*p) : isdigit((unsigned char)*p); p++) {
+            raw = is_hex ? (raw << 4) | (uint32_t)p8_hex_val(*p) : raw * 10 + (uint32_t)(*p - '0');
         }
-
-        const char *s = s_raw + pos;
-        if (memchr(s, '\0', remaining))
-        {
-            lua_pushnil(L);
-            return 1;
+        if (p == digits) return false;
+        bits = (int32_t)(neg ? 0u - raw : raw);
+    }
+    // PICO-8 supports "0x..." for both Integers and Fixed Point (0x0.8000 = 0.5)
+    else if (is_hex)
+    {
+        if (*p == '+' || *p == '-') {
+            neg = (*p == '-');
+            p++;
+        }
+        if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            p += 2;
         }
 
-        std::string tmp(s, remaining);
-        const char *cstr = tmp.c_str();
-
-        char *end = nullptr;
-        double res = 0.0;
-        bool force_hex = (flags & 1) != 0;
-
-        // PICO-8 supports "0x..." for both Integers and Fixed Point (0x0.8000 = 0.5)
-        // For Mario.p8, we specifically need to catch the integer cases safely.
-        if (force_hex || (remaining > 2 && cstr[0] == '0' && (cstr[1] == 'x' || cstr[1] == 'X')))
-        {
-            const char *p = cstr;
-            bool neg = false;
-            if (*p == '+' || *p == '-') {
-                neg = (*p == '-');
-                p++;
-            }
-            if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
-                p += 2;
-            }
+        uint32_t int_part = 0;
+        int int_digits = 0;
+        while (*p && isxdigit((unsigned char)*p)) {
+            int_part = (int_part << 4) | (uint32_t)p8_hex_val(*p);
+            p++;
+            int_digits++;
+        }
 
-            uint32_t int_part = 0;
-            int int_digits = 0;
+        uint32_t frac_part = 0;
+        int frac_digits = 0;
+        if (*p == '.') {
+            p++;
             while (*p && isxdigit((unsigned char)*p)) {
-                int_part = (int_part << 4) | (uint32_t)p8_hex_val(*p);
+                if (frac_digits < 4) {
+                    frac_part = (frac_part << 4) | (uint32_t)p8_hex_val(*p);
+                    frac_digits++;
+                }
                 p++;
-                int_digits++;
             }
+        }
+        if (int_digits == 0 && frac_digits == 0) return false;
 
-            uint32_t frac_part = 0;
-            int frac_digits = 0;
-            if (*p == '.') {
-                p++;
-                while (*p && isxdigit((unsigned char)*p)) {
-                    if (frac_digits < 4) {
-                        frac_part = (frac_part << 4) | (uint32_t)p8_hex_val(*p);
-                        frac_digits++;
-                    }
-                    p++;
-                }
-            }
+        uint32_t raw = int_part << 16;
+        if (frac_digits > 0) {
+            raw |= frac_part << (16 - 4 * frac_digits);
+        }
+        bits = neg ? -(int32_t)raw : (int32_t)raw;
+    }
+    // Binary (0b): the first 16 fraction digits count, like the literal
+    else if (remaining > 2 && s[0] == '0' && (s[1] == 'b' || s[1] == 'B'))
+    {
+        p = s + 2;
+        uint32_t int_part = 0;
+        uint32_t frac_part = 0;
+        int frac_digits = 0;
+        bool in_frac = false;
 
-            const char *tail = p;
-            while (*tail && isspace((unsigned char)*tail)) {
-                tail++;
+        for (; *p; p++)
+        {
+            if (*p == '.')
+            {
+                if (in_frac)
+                    break;
+                in_frac = true;
             }
-
-            if ((int_digits == 0 && frac_digits == 0) || *tail != '\0')
+            else if (*p == '0' || *p == '1')
             {
-                lua_pushnil(L);
-                return 1;
+                if (!in_frac)
+                    int_part = (int_part << 1) | (uint32_t)(*p - '0');
+                else if (frac_digits < 16)
+                    frac_part |= (uint32_t)(*p - '0') << (15 - frac_digits++);
             }
-
-            uint32_t raw = int_part << 16;
-            if (frac_digits > 0) {
-                raw |= frac_part << (16 - 4 * frac_digits);
+            else
+            {
+                break;
             }
-            int32_t signed_raw = neg ? -(int32_t)raw : (int32_t)raw;
-            push_pico_fixed(L, signed_raw);
-            return 1;
         }
+        bits = (int32_t)((int_part << 16) | frac_part);
+    }
+    else
+    {
+        // Standard Decimal
+        char *end = nullptr;
+        bits = z8::fix32::fromstr(s, &end).bits();
+        if (end == s) return false;
+        p = end;
+    }
 
-        // Binary (0b) Handling
-        else if (!force_hex && remaining > 2 && cstr[0] == '0' && (cstr[1] == 'b' || cstr[1] == 'B'))
-        {
-            const char *bin = cstr + 2;
-            long int_part = 0;
-            double frac_part = 0.0;
-            double div = 2.0;
-            bool in_frac = false;
+    // PICO-8 Tolerance: Skip trailing whitespace
+    while (*p && isspace((unsigned char)*p))
+    {
+        p++;
+    }
 
-            while (*bin)
-            {
-                if (*bin == '.')
-                {
-                    if (in_frac)
-                        break;
-                    in_frac = true;
-                }
-                else if (*bin == '0' || *bin == '1')
-                {
-                    if (!in_frac)
-                    {
-                        int_part = (int_part << 1) | (*bin - '0');
-                    }
-                    else
-                    {
-                        if (*bin == '1')
-                            frac_part += (1.0 / div);
-                        div *= 2.0;
-                    }
-                }
-                else
-                {
-                    break;
-                }
-                bin++;
-            }
-            end = (char *)bin;
-            res = (double)int_part + frac_part;
-        }
-        else
-        {
-            // Standard Decimal
-            res = strtod(cstr, &end);
-        }
+    // Strictness: Any NON-SPACE trailing garbage = nil
+    return *p == '\0';
+}
 
-        // PICO-8 Tolerance: Skip trailing whitespace
-        while (*end && isspace((unsigned char)*end))
-        {
-            end++;
-        }
+// Flag 0x4 turns a failed conversion into 0 instead of nil.
+static int internal_tonum(lua_State *L, int idx, int flags)
+{
+    // 1. Handle Number (Identity)
+    if (lua_type(L, idx) == LUA_TNUMBER)
+    {
+        lua_pushvalue(L, idx);
+        return 1;
+    }
 
-        // Strictness: Any NON-SPACE trailing garbage = nil
-        if (end == cstr || *end != '\0')
-        {
-            lua_pushnil(L);
-        }
-        else
+    // 2. Handle Boolean (PICO-8 returns 1 or 0)
+    if (lua_isboolean(L, idx))
+    {
+        int val = lua_toboolean(L, idx);
+        lua_pushnumber(L, val ? 1.0 : 0.0);
+        return 1;
+    }
+
+    // 3. Handle String
+    if (lua_isstring(L, idx))
+    {
+        size_t len;
+        const char *s = lua_tolstring(L, idx, &len);
+        int32_t bits = 0;
+        if (parse_tonum(s, len, flags, bits))
         {
-            lua_pushnumber(L, res);
+            push_pico_fixed(L, bits);
+            return 1;
         }
-        return 1;
     }
 
-    lua_pushnil(L);
+    if (flags & 4)
+        push_pico_fixed(L, 0);
+    else
+        lua_pushnil(L);
     return 1;
 }
 
@@ -4151,224 +4016,29 @@ static int l_split(lua_State *L)
     return 1;
 }
 
-static int l_add(lua_State *L)
-{
-    REAL8_TRACE_API("add");
-    luaL_checktype(L, 1, LUA_TTABLE);
-    int len = (int)lua_rawlen(L, 1);
-
-    // Case 1: add(t, v, index)
-    if (lua_gettop(L) >= 3 && !lua_isnil(L, 3))
-    {
-        int idx = to_int_floor(L, 3);
-        lua_pushvalue(L, 2); // Push v
-
-        // This is effectively table.insert(t, idx, v)
-        // We need to shift elements up if idx <= len.
-        // Lua's table.insert does this, but since we are in C, we can just call table.insert helper logic
-        // Or essentially use lua_rotate if using Lua 5.3 API, but simple way:
-
-        // Move elements up
-        for (int i = len; i >= idx; --i)
-        {
-            lua_rawgeti(L, 1, i);
-            lua_rawseti(L, 1, i + 1);
-        }
-        lua_rawseti(L, 1, idx);
-
-        lua_pushvalue(L, 2); // return v
-        return 1;
-    }
-
-    // Case 2: add(t, v) - Append
-    lua_pushvalue(L, 2);
-    lua_rawseti(L, 1, len + 1);
-    lua_pushvalue(L, 2);
-    return 1;
-}
-
-// Replaces Lua 'del'
-static int l_del(lua_State *L)
-{
-    REAL8_TRACE_API("del");
-    luaL_checktype(L, 1, LUA_TTABLE);
-    // del(t, v) removes first instance of v, returns v
-    if (lua_gettop(L) < 2)
-        return 0;
-
-    int len = (int)lua_rawlen(L, 1);
-    bool found = false;
-
-    // Scan table
-    for (int i = 1; i <= len; i++)
-    {
-        lua_rawgeti(L, 1, i);
-        if (lua_compare(L, -1, 2, LUA_OPEQ))
-        {
-            lua_pop(L, 1); // pop item
-
-            // Move everything down (Lua table.remove logic)
-            // This is slow O(N), but matches PICO-8 behavior
-            for (int j = i; j < len; j++)
-            {
-                lua_rawgeti(L, 1, j + 1);
-                lua_rawseti(L, 1, j);
-            }
-            lua_pushnil(L);
-            lua_rawseti(L, 1, len); // Clear last
-
-            found = true;
-            break;
-        }
-        lua_pop(L, 1);
-    }
-
-    if (found)
-        lua_pushvalue(L, 2); // Return deleted item
-    else
-        lua_pushnil(L);
-    return 1;
-}
-
 static int l_flr(lua_State *L)
 {
-    double x = luaL_optnumber(L, 1, 0.0);
-    lua_pushnumber(L, floor(x));
+    push_pico_fixed(L, to_pico_fixed(L, 1) & (int32_t)0xffff0000);
     return 1;
 }
 
 static int l_ceil(lua_State *L)
 {
-    double x = luaL_optnumber(L, 1, 0.0);
-    lua_pushnumber(L, ceil(x));
+    lua_pushnumber(L, lua_Number::ceil(lua_Number::frombits(to_pico_fixed(L, 1))));
     return 1;
 }
 
 static int l_abs(lua_State *L)
 {
-    double x = luaL_optnumber(L, 1, 0.0);
-    lua_pushnumber(L, fabs(x)); // fabs for floats
+    // abs(0x8000) is 0x7fff.ffff on PICO-8
+    lua_pushnumber(L, lua_Number::abs(lua_Number::frombits(to_pico_fixed(L, 1))));
     return 1;
 }
 
 static int l_sgn(lua_State *L)
 {
-    double x = luaL_optnumber(L, 1, 0.0);
     // PICO-8 sgn: x < 0 -> -1, x >= 0 -> 1
-    lua_pushinteger(L, (x < 0) ? -1 : 1);
-    return 1;
-}
-
-// Replaces Lua 'deli' (delete by index)
-static int l_deli(lua_State *L)
-{
-    REAL8_TRACE_API("deli");
-    luaL_checktype(L, 1, LUA_TTABLE);
-    int len = (int)lua_rawlen(L, 1);
-    // Default index is length (remove last)
-    int idx = (lua_gettop(L) >= 2) ? to_int_floor(L, 2) : len;
-
-    if (idx < 1 || idx > len)
-    {
-        lua_pushnil(L);
-        return 1;
-    }
-
-    // Get value to return
-    lua_rawgeti(L, 1, idx);
-
-    // Shift elements down
-    for (int i = idx; i < len; i++)
-    {
-        lua_rawgeti(L, 1, i + 1);
-        lua_rawseti(L, 1, i);
-    }
-
-    // Clear last element
-    lua_pushnil(L);
-    lua_rawseti(L, 1, len);
-
-    return 1; // Return the deleted value
-}
-
-static int l_count(lua_State *L)
-{
-    if (lua_isnil(L, 1))
-    {
-        lua_pushinteger(L, 0);
-        return 1;
-    }
-    luaL_checktype(L, 1, LUA_TTABLE);
-
-    // count(t) -> return length
-    if (lua_gettop(L) == 1 || lua_isnil(L, 2))
-    {
-        lua_pushinteger(L, lua_rawlen(L, 1));
-        return 1;
-    }
-
-    // count(t, val) -> count instances of val
-    int count = 0;
-    int len = (int)lua_rawlen(L, 1);
-
-    // We must traverse 1..len (PICO-8 arrays)
-    for (int i = 1; i <= len; i++)
-    {
-        lua_rawgeti(L, 1, i);
-        if (lua_compare(L, -1, 2, LUA_OPEQ))
-        {
-            count++;
-        }
-        lua_pop(L, 1);
-    }
-    lua_pushinteger(L, count);
-    return 1;
-}
-
-// Iterator function called by the for-loop
-static int l_all_iter(lua_State *L)
-{
-    // Upvalue 1: Table
-    // Upvalue 2: Current Index (integer)
-
-    int i = lua_tointeger(L, lua_upvalueindex(2));
-    i++;
-
-    // Update Index
-    lua_pushinteger(L, i);
-    lua_replace(L, lua_upvalueindex(2));
-
-    // Get t[i]
-    lua_rawgeti(L, lua_upvalueindex(1), i);
-
-    if (lua_isnil(L, -1))
-    {
-        return 0; // Stop iteration
-    }
-
-    return 1; // Return value
-}
-
-// The all(t) function
-static int l_all(lua_State *L)
-{
-    REAL8_TRACE_API("all");
-    // If the argument is nil, return a dummy iterator that does nothing.
-    // This prevents crashes when iterating over uninitialized tables.
-    if (lua_isnil(L, 1))
-    {
-        lua_pushcfunction(L, [](lua_State *L) -> int
-                          { return 0; });
-        return 1;
-    }
-
-    luaL_checktype(L, 1, LUA_TTABLE);
-
-    lua_pushvalue(L, 1);   // Push table (becomes Upvalue 1)
-    lua_pushinteger(L, 0); // Push index 0 (becomes Upvalue 2)
-
-    // Push closure with 2 upvalues
-    lua_pushcclosure(L, l_all_iter, 2);
+    lua_pushinteger(L, to_pico_fixed(L, 1) < 0 ? -1 : 1);
     return 1;
 }
 
@@ -4451,31 +4121,15 @@ static int l_tostr(lua_State *L)
             flags = (int)lua_tonumber(L, 2);
     }
 
-    if (flags & 2)
+    if (flags || lua_type(L, 1) == LUA_TNUMBER)
     {
-        int32_t fixed = to_pico_fixed(L, 1);
-        char buf[4];
-        buf[0] = (char)(fixed & 0xFF);
-        buf[1] = (char)((fixed >> 8) & 0xFF);
-        buf[2] = (char)((fixed >> 16) & 0xFF);
-        buf[3] = (char)((fixed >> 24) & 0xFF);
-        lua_pushlstring(L, buf, 4);
-    }
-    else if (flags & 1)
-    {
-        double val = lua_tonumber(L, 1);
-        // Convert to PICO-8 16.16 fixed point
-        int32_t fixed = (int32_t)(val * 65536.0);
-        uint16_t upper = (fixed >> 16) & 0xFFFF;
-        uint16_t lower = fixed & 0xFFFF;
-
-        char buf[16];
-        snprintf(buf, 16, "0x%04x.%04x", upper, lower);
-        lua_pushstring(L, buf);
+        // 0x1 hex "0x1234.abcd", 0x2 the bits as an integer, 0x3 both
+        char buf[12];
+        int len = z8::fix32::tostr(buf, z8::fix32::frombits(to_pico_fixed(L, 1)), flags);
+        lua_pushlstring(L, buf, (size_t)len);
     }
     else
     {
-        // Standard number to string
         lua_pushstring(L, lua_tostring(L, 1));
     }
 
@@ -4808,6 +4462,74 @@ static int l_rotr(lua_State *L)
     return 1;
 }
 
+// --- Draw lists (Real8 extension) ---
+// One serial(0x810, list [, len]) call replays a flat array of records,
+// each an opcode followed by its fixed arguments:
+//   1 pset x y c              2 rectfill x0 y0 x1 y1 c    3 rect x0 y0 x1 y1 c
+//   4 circfill x y r c        5 circ x y r c              6 line x0 y0 x1 y1 c
+//   7 spr n x y
+// A nil color uses the pen, as in the single calls. len (default #list)
+// lets a cart reuse one table across frames without clearing it. Returns
+// the number of records drawn; real PICO-8 ignores the channel and returns
+// nil, so carts fall back to plain calls with:
+//   if not serial(0x810, list, n) then <draw each record> end
+enum {
+    DL_PSET = 1, DL_RECTFILL, DL_RECT, DL_CIRCFILL, DL_CIRC, DL_LINE, DL_SPR
+};
+
+static const uint8_t kDrawListArgs[] = { 0, 3, 5, 5, 4, 4, 5, 3 };
+
+static int draw_list(lua_State *L, Real8VM *vm)
+{
+    REAL8_TRACE_API("drawlist");
+    luaL_checktype(L, 2, LUA_TTABLE);
+    const int len = lua_isnoneornil(L, 3) ? (int)lua_rawlen(L, 2) : to_int_floor(L, 3);
+    Real8Gfx &gpu = vm->gpu;
+    const uint8_t pen = gpu.getPen();
+
+    int count = 0;
+    int i = 1;
+    while (i <= len) {
+        int32_t op = 0;
+        lua_rawgetfix32s(L, 2, i, 1, &op);
+        op >>= 16;
+        if (op < DL_PSET || op > DL_SPR) return luaL_error(L, "drawlist: bad opcode %d at %d", op, i);
+        const int nargs = kDrawListArgs[op];
+        if (i + nargs > len) break;
+
+        int32_t a[5] = { 0, 0, 0, 0, 0 };
+        const unsigned present = lua_rawgetfix32s(L, 2, i + 1, nargs, a);
+        const int v0 = a[0] >> 16, v1 = a[1] >> 16, v2 = a[2] >> 16, v3 = a[3] >> 16;
+        // Shape ops end with an optional colour; spr (n x y) has none.
+        uint8_t c = pen;
+        if (op != DL_SPR) {
+            const int clast = nargs - 1;
+            if ((present >> clast) & 1) c = (uint8_t)((a[clast] >> 16) & 0x0F);
+        }
+
+        switch (op) {
+        case DL_PSET: gpu.pset(v0, v1, c); break;
+        case DL_RECTFILL: gpu.rectfill(v0, v1, v2, v3, c); break;
+        case DL_RECT: gpu.rect(v0, v1, v2, v3, c); break;
+        case DL_CIRCFILL: gpu.circfill(v0, v1, v2, c); break;
+        case DL_CIRC: gpu.circ(v0, v1, v2, c); break;
+        case DL_LINE:
+            gpu.line(v0, v1, v2, v3, c);
+            gpu.last_line_x = v2;
+            gpu.last_line_y = v3;
+            break;
+        case DL_SPR:
+            debug_spr_count++;
+            gpu.spr(v0, (int16_t)v1, (int16_t)v2);
+            break;
+        }
+        count++;
+        i += 1 + nargs;
+    }
+    lua_pushinteger(L, count);
+    return 1;
+}
+
 static int l_serial(lua_State *L)
 {
     auto *vm = get_vm(L);
@@ -4861,7 +4583,13 @@ static int l_serial(lua_State *L)
         return 1;
     }
 
-    // --- 6. Bulk Data Stream (Official PICO-8 Style) ---
+    // --- 6. Draw List ---
+    // Usage: n = serial(0x810, list, [len])
+    if (channel == 0x810) {
+        return draw_list(L, vm);
+    }
+
+    // --- 7. Bulk Data Stream (Official PICO-8 Style) ---
     // Usage: serial(0x400, ram_addr, len)
     // Great for NeoPixels or UART buffers
     if (channel == 0x400) { // Arbitrary channel for data stream
@@ -5717,12 +5445,8 @@ void register_pico8_api(lua_State *L)
     gbaLog("[BOOT] REG STR OK");
 
     // --- Tables ---
-    reg(L, "add", l_add);
-    reg(L, "del", l_del);
-    reg(L, "deli", l_deli);
-    reg(L, "count", l_count);
-    reg(L, "all", l_all);
-    reg(L, "all_iter", l_all_iter);
+    // add/del/deli/count/all come from z8lua's luaopen_pico8, which works on
+    // the table's array part directly.
     reg(L, "foreach", l_foreach);
     reg(L, "pairs", l_pairs);
     reg(L, "ipairs", l_ipairs);
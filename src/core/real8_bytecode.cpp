@@ -0,0 +1,202 @@
+#include "real8_bytecode.h"
+#include "../../lib/z8lua/lua.h"
+#include "../../lib/z8lua/lauxlib.h"
+
+// --------------------------------------------------------------------------
+// CHUNK LAYOUT (Lua 5.2, see ldump.cpp)
+// --------------------------------------------------------------------------
+// header: "\x1bLua" | version | format | endian | sizeof int | sizeof size_t |
+//         sizeof Instruction | sizeof lua_Number | integral | LUAC_TAIL
+// function: int linedefined | int lastlinedefined | u8 params | u8 vararg |
+//           u8 maxstack | int n + code | int n + constants | int n + protos |
+//           int n + upvalues (2 bytes each) | string source |
+//           int n + lineinfo | int n + (string, int, int) locvars |
+//           int n + upvalue name strings
+// string: size_t length including the NUL, 0 for none.
+
+namespace {
+
+const size_t HEADER_SIZE = 18;
+const size_t HDR_ENDIAN = 6;
+const size_t HDR_INT = 7;
+const size_t HDR_SIZE_T = 8;
+const size_t HDR_INSTRUCTION = 9;
+const size_t HDR_NUMBER = 10;
+const int MAX_DEPTH = 200; // the parser's own nesting limit is lower
+
+int appendChunk(lua_State *L, const void *p, size_t sz, void *ud) {
+    (void)L;
+    std::vector<uint8_t> *out = (std::vector<uint8_t> *)ud;
+    out->insert(out->end(), (const uint8_t *)p, (const uint8_t *)p + sz);
+    return 0;
+}
+
+// Copies a host chunk while re-encoding every size_t to the target width.
+struct ChunkRewriter {
+    const uint8_t *p;
+    const uint8_t *end;
+    std::vector<uint8_t> &out;
+    size_t srcSizeT;
+    size_t dstSizeT;
+    size_t numberSize;
+    bool strip;
+    bool ok = true;
+
+    ChunkRewriter(const std::vector<uint8_t> &in, std::vector<uint8_t> &o)
+        : p(in.data()), end(in.data() + in.size()), out(o) {}
+
+    bool need(size_t n) { if ((size_t)(end - p) < n) ok = false; return ok; }
+    void skip(size_t n) { if (need(n)) p += n; }
+    void copy(size_t n) {
+        if (!need(n)) return;
+        out.insert(out.end(), p, p + n);
+        p += n;
+    }
+    uint8_t byte() {
+        if (!need(1)) return 0;
+        out.push_back(*p);
+        return *p++;
+    }
+    int32_t peekInt() const {
+        return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+    }
+    int32_t readInt() {
+        if (!need(4)) return 0;
+        int32_t v = peekInt();
+        p += 4;
+        if (v < 0) ok = false;
+        return v;
+    }
+    int32_t integer() {
+        int32_t v = readInt();
+        writeInt(v);
+        return v;
+    }
+    void writeInt(int32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back((uint8_t)((uint32_t)v >> (8 * i)));
+    }
+    void writeSize(uint64_t v) {
+        for (size_t i = 0; i < dstSizeT; i++) out.push_back(i < 8 ? (uint8_t)(v >> (8 * i)) : 0);
+    }
+    uint64_t readSize() {
+        if (!need(srcSizeT)) return 0;
+        uint64_t v = 0;
+        for (size_t i = 0; i < srcSizeT; i++) {
+            if (i < 8) v |= (uint64_t)p[i] << (8 * i);
+            else if (p[i]) ok = false;
+        }
+        p += srcSizeT;
+        if (dstSizeT < 8 && (v >> (8 * dstSizeT)) != 0) ok = false;
+        return v;
+    }
+    void string() {
+        uint64_t n = readSize();
+        if (!ok) return;
+        writeSize(n);
+        copy((size_t)n);
+    }
+    void skipString() {
+        uint64_t n = readSize();
+        if (ok) skip((size_t)n);
+    }
+
+    void function(int depth) {
+        if (depth > MAX_DEPTH) { ok = false; return; }
+        integer();                    // linedefined
+        integer();                    // lastlinedefined
+        copy(3);                      // numparams, is_vararg, maxstacksize
+        int32_t n = integer();        // code
+        copy((size_t)n * 4);
+
+        n = integer();                // constants
+        for (int32_t i = 0; i < n && ok; i++) {
+            switch (byte()) {
+            case LUA_TNIL: break;
+            case LUA_TBOOLEAN: copy(1); break;
+            case LUA_TNUMBER: copy(numberSize); break;
+            case LUA_TSTRING: string(); break;
+            default: ok = false; break;
+            }
+        }
+        n = integer();                // protos
+        for (int32_t i = 0; i < n && ok; i++) function(depth + 1);
+        n = integer();                // upvalues: instack, idx
+        copy((size_t)n * 2);
+
+        // Debug info
+        if (!strip) {
+            string();                 // source
+            n = integer();            // lineinfo
+            copy((size_t)n * 4);
+            n = integer();            // locvars
+            for (int32_t i = 0; i < n && ok; i++) { string(); copy(8); }
+            n = integer();            // upvalue names
+            for (int32_t i = 0; i < n && ok; i++) string();
+            return;
+        }
+        skipString();
+        writeSize(0);
+        skip((size_t)readInt() * 4);
+        n = readInt();
+        for (int32_t i = 0; i < n && ok; i++) { skipString(); skip(8); }
+        n = readInt();
+        for (int32_t i = 0; i < n && ok; i++) skipString();
+        writeInt(0);
+        writeInt(0);
+        writeInt(0);
+    }
+};
+
+} // namespace
+
+bool compile_pico8_bytecode(const char *src, size_t len, unsigned targetSizeT, bool strip,
+                            std::vector<uint8_t> &out, std::string &err)
+{
+    out.clear();
+    if (targetSizeT != 4 && targetSizeT != 8) {
+        err = "Unsupported target size_t width.";
+        return false;
+    }
+
+    lua_State *L = luaL_newstate();
+    if (!L) {
+        err = "Failed to create Lua state.";
+        return false;
+    }
+    std::vector<uint8_t> chunk;
+    if (luaL_loadbuffer(L, src, len, "cart") != LUA_OK) {
+        const char *msg = lua_tostring(L, -1);
+        err = std::string("Lua compile failed: ") + (msg ? msg : "(unknown parse error)");
+        lua_close(L);
+        return false;
+    }
+    int status = lua_dump(L, appendChunk, &chunk);
+    lua_close(L);
+    if (status != 0 || chunk.size() < HEADER_SIZE) {
+        err = "Failed to dump Lua bytecode.";
+        return false;
+    }
+
+    if (chunk[HDR_ENDIAN] != 1 || chunk[HDR_INT] != 4 || chunk[HDR_INSTRUCTION] != 4) {
+        err = "Host Lua chunk layout does not match the device.";
+        return false;
+    }
+
+    out.reserve(chunk.size());
+    out.insert(out.end(), chunk.begin(), chunk.begin() + HEADER_SIZE);
+    out[HDR_SIZE_T] = (uint8_t)targetSizeT;
+
+    ChunkRewriter w(chunk, out);
+    w.p += HEADER_SIZE;
+    w.srcSizeT = chunk[HDR_SIZE_T];
+    w.dstSizeT = targetSizeT;
+    w.numberSize = chunk[HDR_NUMBER];
+    w.strip = strip;
+    w.function(0);
+    if (!w.ok || w.p != w.end) {
+        out.clear();
+        err = "Malformed Lua chunk.";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Ahead-of-time compilation of cart Lua for the standalone exports.
+//
+// The source is compiled by the host's z8lua and the chunk is rewritten for
+// the target's size_t width, the only layout difference between the desktop
+// hosts and the GBA/3DS/Switch builds (all little-endian, 32-bit int and
+// Instruction, fix32 numbers). The device then only runs lundump.
+//
+// strip drops line info and local/upvalue names: smaller chunks and less
+// heap on the device, but runtime errors lose their line numbers.
+bool compile_pico8_bytecode(const char* src, size_t len, unsigned targetSizeT, bool strip,
+                            std::vector<uint8_t>& out, std::string& err);
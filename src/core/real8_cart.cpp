@@ -1,8 +1,9 @@
 #include "real8_cart.h"
 #include "real8_compression.h"
-#include <lodePNG.h> 
+#include "real8_png.h"
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <algorithm>
@@ -12,32 +13,81 @@
 // STATIC HELPERS
 // --------------------------------------------------------------------------
 
+// Hex digit values, -1 for anything else.
+struct HexTable {
+    int8_t v[256];
+    constexpr HexTable() : v() {
+        for (int i = 0; i < 256; i++) v[i] = -1;
+        for (int i = 0; i < 10; i++) v['0' + i] = (int8_t)i;
+        for (int i = 0; i < 6; i++) { v['a' + i] = (int8_t)(10 + i); v['A' + i] = (int8_t)(10 + i); }
+    }
+};
+static constexpr HexTable HEX;
+
+static inline int hex_value(char c) { return HEX.v[(unsigned char)c]; }
+static inline bool is_hex(char c) { return HEX.v[(unsigned char)c] >= 0; }
 static inline int p8_hex(char c) {
-    if (c >= '0' && c <= '9') return c - '0';
-    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-    return 0;
+    int v = hex_value(c);
+    return v < 0 ? 0 : v;
 }
 
-// Extracts a specific section (e.g., "__lua__") from the p8 text file
-static std::string extractSection(const std::string &src, const char *name) {
-    size_t start = src.find(name);
-    if (start == std::string::npos) return "";
-    start += strlen(name);
-    // Skip newlines/whitespace after the tag
-    while (start < src.length() && (src[start] == '_' || src[start] == '\n' || src[start] == '\r')) start++;
-    
-    size_t end = src.find("\n__", start);
-    if (end == std::string::npos) end = src.length();
-    
-    return src.substr(start, end - start);
+// Maps a "__name__" header line to its slot; nullptr for unknown sections
+// and for repeats (the first occurrence wins).
+static std::string_view *sectionSlot(P8TextSections &out, std::string_view name) {
+    std::string_view *slot = nullptr;
+    if (name == "__lua__") slot = &out.lua;
+    else if (name == "__gfx__") slot = &out.gfx;
+    else if (name == "__gff__") slot = &out.gff;
+    else if (name == "__label__") slot = &out.label;
+    else if (name == "__map__") slot = &out.map;
+    else if (name == "__sfx__") slot = &out.sfx;
+    else if (name == "__music__") slot = &out.music;
+    return (slot && slot->data() == nullptr) ? slot : nullptr;
 }
 
+// Cursor over a section view. Reads past the end yield '\0', matching the
+// NUL-terminated copies the parsers below were written against.
+struct SectionCursor {
+    const char *p;
+    const char *end;
+
+    explicit SectionCursor(std::string_view s) : p(s.data()), end(s.data() + s.size()) {}
+    char operator*() const { return p < end ? *p : '\0'; }
+    char operator[](size_t i) const { return (size_t)(end - p) > i ? p[i] : '\0'; }
+    char next() { char c = **this; if (p < end) p++; return c; }
+    void skip(size_t n) { p = (size_t)(end - p) > n ? p + n : end; }
+
+    // strtol(p, &p, 10) without the terminator requirement.
+    long number() {
+        const char *q = p;
+        bool neg = false;
+        if (q < end && (*q == '-' || *q == '+')) { neg = (*q == '-'); q++; }
+        if (q >= end || !isdigit((unsigned char)*q)) return 0;
+        long v = 0;
+        for (; q < end && isdigit((unsigned char)*q); q++) if (v < 100000000) v = v * 10 + (*q - '0');
+        p = q;
+        return neg ? -v : v;
+    }
+};
+
 // --------------------------------------------------------------------------
 // LOADER IMPLEMENTATION
 // --------------------------------------------------------------------------
 
-bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t>& buffer, GameData& outData) {    // 1. Clear Output Data
+bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t>& buffer, GameData& outData) {
+    return LoadFromMemory(host, buffer.data(), buffer.size(), outData);
+}
+
+uint64_t Real8CartLoader::ContentHash(const uint8_t* data, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+bool Real8CartLoader::LoadFromMemory(IReal8Host* host, const uint8_t* data, size_t size, GameData& outData) {    // 1. Clear Output Data
     memset(outData.gfx, 0, sizeof(outData.gfx));
     memset(outData.map, 0, sizeof(outData.map));
     memset(outData.sfx, 0, sizeof(outData.sfx));
@@ -47,37 +97,23 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     outData.lua_code_ptr = nullptr;
     outData.lua_code_size = 0;
     outData.cart_id = ""; // Ensure you added this field to GameData in .h
+    outData.content_hash = ContentHash(data, size);
+    outData.bytecode.clear();
+    outData.bytecode_key = 0;
 
-    if (buffer.empty()) return false;
+    if (!data || size == 0) return false;
 
     // ----------------------------------------------------------------------
     // FORMAT A: PNG CART
     // ----------------------------------------------------------------------
-    if (buffer.size() > 8 && buffer[0] == 0x89 && buffer[1] == 'P' && buffer[2] == 'N' && buffer[3] == 'G') {
-        unsigned w, h;
-        unsigned char *image = nullptr;
-        unsigned error = lodepng_decode32(&image, &w, &h, buffer.data(), buffer.size());
-
-        if (error || !image) { if(image) free(image); return false; }
-
-        // Decode PICO-8 Steganography (RGBA low bits -> Byte)
-        std::vector<uint8_t> cart_data;
-        cart_data.reserve(0x8000); // 32KB Standard Cart
-        size_t total_pixels = w * h;
-
-        for (size_t i = 0; i < total_pixels; ++i) {
-            if (cart_data.size() >= 0x8000) break;
-            uint8_t r = image[i * 4 + 0];
-            uint8_t g = image[i * 4 + 1];
-            uint8_t b = image[i * 4 + 2];
-            uint8_t a = image[i * 4 + 3];
-            // Decode: A(2) R(2) G(2) B(2)
-            uint8_t val = ((a & 3) << 6) | ((r & 3) << 4) | ((g & 3) << 2) | (b & 3);
-            cart_data.push_back(val);
-        }
-        free(image);
+    if (size > 8 && data[0] == 0x89 && data[1] == 'P' && data[2] == 'N' && data[3] == 'G') {
+        // Decode PICO-8 Steganography (RGBA low bits -> Byte), streamed
+        // straight out of the IDAT data without a full RGBA image.
+        std::vector<uint8_t> cart_data(0x8000); // 32KB Standard Cart
+        size_t cart_len = 0;
+        if (!Real8PngCart::Decode(data, size, cart_data.data(), cart_data.size(), &cart_len, nullptr, nullptr)) return false;
 
-        if (cart_data.size() < 0x4300) return false;
+        if (cart_len < 0x4300) return false;
 
         // Copy GFX (0x0000 - 0x1FFF)
         memcpy(outData.gfx, cart_data.data() + 0x0000, 0x2000);
@@ -111,15 +147,16 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     // ----------------------------------------------------------------------
     // FORMAT B: TEXT CART (.p8)
     // ----------------------------------------------------------------------
-    std::string content(buffer.begin(), buffer.end());
+    P8TextSections sections;
+    SplitTextSections((const char *)data, size, sections);
 
     // 1. GFX (__gfx__)
-    std::string gfxData = extractSection(content, "__gfx__");
+    std::string_view gfxData = sections.gfx;
     if (!gfxData.empty()) {
         int x = 0, y = 0;
         for (char c : gfxData) {
-            if (!isxdigit((unsigned char)c)) continue;
-            int v = p8_hex(c);
+            int v = hex_value(c);
+            if (v < 0) continue;
             if (y < 128 && x < 128) {
                 // Pixel Logic: 2 pixels per byte (low nibble = even x, high nibble = odd x)
                 // Note: PICO-8 memory is (val & 0x0F) for even, (val >> 4) for odd?
@@ -139,12 +176,12 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     }
 
     // 2. GFF (__gff__)
-    std::string gffData = extractSection(content, "__gff__");
+    std::string_view gffData = sections.gff;
     if (!gffData.empty()) {
         int idx = 0; bool high = true; uint8_t val = 0;
         for (char c : gffData) {
-            if (!isxdigit((unsigned char)c)) continue;
-            int v = p8_hex(c);
+            int v = hex_value(c);
+            if (v < 0) continue;
             // Text GFF is usually linear hex bytes
             if (high) { val = v << 4; high = false; }
             else {
@@ -155,12 +192,12 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     }
 
     // 3. MAP (__map__)
-    std::string mapSec = extractSection(content, "__map__");
+    std::string_view mapSec = sections.map;
     if (!mapSec.empty()) {
         int x = 0, y = 0; bool high = true; uint8_t val = 0;
         for (char c : mapSec) {
-            if (!isxdigit((unsigned char)c)) continue;
-            int v = p8_hex(c);
+            int v = hex_value(c);
+            if (v < 0) continue;
             // Map data in RAM is straight bytes, one byte per tile
             if (high) { val = v << 4; high = false; }
             else {
@@ -174,23 +211,23 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     }
 
     // 4. MUSIC (__music__)
-    std::string musData = extractSection(content, "__music__");
+    std::string_view musData = sections.music;
     if (!musData.empty()) {
         int pat = 0;
-        const char *p = musData.c_str();
+        SectionCursor p(musData);
         while (*p && pat < 64) {
-            while (*p && !isxdigit((unsigned char)*p)) p++;
+            while (*p && !is_hex(*p)) p.next();
             if (!*p) break;
 
-            int flags = p8_hex(*p++);
-            if (isxdigit((unsigned char)*p)) flags = (flags << 4) | p8_hex(*p++);
-            while (*p && !isxdigit((unsigned char)*p) && *p != '-') p++;
+            int flags = p8_hex(p.next());
+            if (is_hex(*p)) flags = (flags << 4) | p8_hex(p.next());
+            while (*p && !is_hex(*p) && *p != '-') p.next();
 
             int ch[4] = {-1, -1, -1, -1};
             for(int i=0; i<4; i++) {
                 if (*p) {
-                    ch[i] = strtol(p, (char **)&p, 10);
-                    while (*p && !isdigit((unsigned char)*p) && *p != '-') p++;
+                    ch[i] = p.number();
+                    while (*p && !isdigit((unsigned char)*p) && *p != '-') p.next();
                 }
             }
 
@@ -209,18 +246,18 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     }
 
     // 5. SFX (__sfx__)
-    std::string sfxSec = extractSection(content, "__sfx__");
+    std::string_view sfxSec = sections.sfx;
     if (!sfxSec.empty()) {
         int sfx_id = 0;
-        const char *p = sfxSec.c_str();
+        SectionCursor p(sfxSec);
         while (*p && sfx_id < 64) {
-            while (*p && !isxdigit((unsigned char)*p)) p++;
+            while (*p && !is_hex(*p)) p.next();
             if (!*p) break;
 
             // Editor Mode (Header)
             uint8_t header[4];
             for (int h = 0; h < 4; h++) {
-                int v1 = p8_hex(*p++); int v2 = p8_hex(*p++);
+                int v1 = p8_hex(p.next()); int v2 = p8_hex(p.next());
                 header[h] = (v1 << 4) | v2;
             }
             // Bytes 64-67 of the SFX struct are the header
@@ -228,11 +265,11 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
 
             // Note Data
             for (int n = 0; n < 32; n++) {
-                while (*p && isspace((unsigned char)*p)) p++; 
+                while (*p && isspace((unsigned char)*p)) p.next(); 
                 if (!*p) break;
                 int pitch = (p8_hex(p[0]) << 4) | p8_hex(p[1]);
                 int instr = p8_hex(p[2]); int vol = p8_hex(p[3]); int eff = p8_hex(p[4]);
-                p += 5;
+                p.skip(5);
                 
                 int offset = sfx_id * 68 + (n * 2);
                 outData.sfx[offset] = (uint8_t)pitch;
@@ -243,7 +280,60 @@ bool Real8CartLoader::LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t
     }
 
     // 6. LUA (__lua__)
-    outData.lua_code = extractSection(content, "__lua__");
+    outData.lua_code.assign(sections.lua.data(), sections.lua.size());
 
     return true;
-}
\ No newline at end of file
+}
+// --------------------------------------------------------------------------
+// TEXT CART SECTIONS
+// --------------------------------------------------------------------------
+
+void Real8CartLoader::SplitTextSections(const char* text, size_t size, P8TextSections& out) {
+    out = P8TextSections();
+    if (!text) return;
+
+    const char *end = text + size;
+    std::string_view *cur = nullptr;
+    const char *body = text;
+
+    // Headers are whole lines of the form "__name__"; everything else is
+    // section body. Lua lines that merely start with "__" stay in the code.
+    for (const char *line = text; line < end; ) {
+        const char *nl = (const char *)memchr(line, '\n', end - line);
+        const char *lineEnd = nl ? nl : end;
+
+        const char *t = lineEnd;
+        while (t > line && (t[-1] == '\r' || t[-1] == ' ' || t[-1] == '\t')) t--;
+        if (t - line >= 5 && line[0] == '_' && line[1] == '_' && t[-1] == '_' && t[-2] == '_') {
+            if (cur) *cur = std::string_view(body, line - 1 > body ? (size_t)(line - 1 - body) : 0);
+            cur = sectionSlot(out, std::string_view(line, t - line));
+            body = nl ? nl + 1 : end;
+            // Leading blank lines are not part of the section.
+            while (body < end && (*body == '\n' || *body == '\r')) body++;
+        }
+        line = nl ? nl + 1 : end;
+    }
+    if (cur) *cur = std::string_view(body, end > body ? (size_t)(end - body) : 0);
+}
+
+bool Real8CartLoader::DecodeTextLabel(std::string_view label, uint8_t (*out)[128]) {
+    if (label.empty()) return false;
+    memset(out, 0, 128 * 128);
+
+    // One row per line; g..v select the secret palette (16..31).
+    int x = 0, y = 0;
+    for (char c : label) {
+        if (c == '\n') {
+            if (x > 0 && ++y >= 128) break;
+            x = 0;
+            continue;
+        }
+        int v = hex_value(c);
+        if (v < 0) {
+            if (c < 'g' || c > 'v') continue;
+            v = c - 'g' + 16;
+        }
+        if (x < 128) out[y][x++] = (uint8_t)v;
+    }
+    return true;
+}
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -18,6 +19,9 @@ struct GameData {
     const uint8_t* sprite_flags = nullptr;
     const char* lua_code_ptr = nullptr;
     size_t lua_code_size = 0;
+    // Precompiled chunk from the cart packer, used instead of lua_code_ptr.
+    const uint8_t* bytecode_ptr = nullptr;
+    size_t bytecode_size = 0;
     const char* cart_id = nullptr;
 #else
     uint8_t gfx[0x2000];
@@ -29,10 +33,38 @@ struct GameData {
     const char* lua_code_ptr = nullptr;
     size_t lua_code_size = 0;
     std::string cart_id;
+    // FNV-1a of the raw cart file; keys the bytecode and cart caches.
+    uint64_t content_hash = 0;
+    // Precompiled chunk for lua_code (from Real8CartCache), valid only while
+    // bytecode_key matches the key Real8VM derives for this cart. With no
+    // lua_code it is the cart packer's chunk and is always used.
+    std::vector<uint8_t> bytecode;
+    uint64_t bytecode_key = 0;
 #endif
 };
 
+// Body of each known section of a .p8 text cart, as views into the source.
+// A section that is absent has a null data().
+struct P8TextSections {
+    std::string_view lua;
+    std::string_view gfx;
+    std::string_view gff;
+    std::string_view label;
+    std::string_view map;
+    std::string_view sfx;
+    std::string_view music;
+};
+
 class Real8CartLoader {
 public:
     static bool LoadFromBuffer(IReal8Host* host, const std::vector<uint8_t>& buffer, GameData& outData);
+    // Parses the cart in place (e.g. from a MappedFile); only the Lua source
+    // is copied out of the buffer.
+    static bool LoadFromMemory(IReal8Host* host, const uint8_t* data, size_t size, GameData& outData);
+    static uint64_t ContentHash(const uint8_t* data, size_t size);
+
+    // Finds every section boundary of a .p8 text cart in one pass.
+    static void SplitTextSections(const char* text, size_t size, P8TextSections& out);
+    // Decodes a __label__ body into palette indices; false when empty.
+    static bool DecodeTextLabel(std::string_view label, uint8_t (*out)[128]);
 };
@@ -0,0 +1,184 @@
+#include "real8_cartcache.h"
+#include "real8_vm.h"
+#include "../hal/real8_host.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// --------------------------------------------------------------------------
+// ENTRY FORMAT
+// --------------------------------------------------------------------------
+// cartcache_<hash>.r8c:
+//   "R8CC" | u16 version | str8 REAL8_VERSION | u64 content hash |
+//   u64 bytecode key | gfx | map | gff | music | sfx |
+//   u32 len + Lua source | u32 len + Lua chunk
+// cartcache.idx: "R8CI" | u16 version | u32 count | u64 hash (newest first)
+
+namespace {
+
+const char *INDEX_FILE = "/cartcache.idx";
+const uint32_t ENTRY_MAGIC = 0x43433852; // "R8CC"
+const uint32_t INDEX_MAGIC = 0x49433852; // "R8CI"
+const uint16_t CACHE_VERSION = 1;
+
+struct BlobWriter {
+    std::vector<uint8_t> out;
+    void u8(uint8_t v) { out.push_back(v); }
+    void u16(uint16_t v) { u8((uint8_t)v); u8((uint8_t)(v >> 8)); }
+    void u32(uint32_t v) { u16((uint16_t)v); u16((uint16_t)(v >> 16)); }
+    void u64(uint64_t v) { u32((uint32_t)v); u32((uint32_t)(v >> 32)); }
+    void raw(const void *p, size_t n) { out.insert(out.end(), (const uint8_t *)p, (const uint8_t *)p + n); }
+    void str8(const char *s) {
+        size_t n = std::min<size_t>(strlen(s), 0xFF);
+        u8((uint8_t)n);
+        raw(s, n);
+    }
+};
+
+struct BlobReader {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool ok = true;
+    BlobReader(const std::vector<uint8_t> &v) : p(v.data()), end(v.data() + v.size()) {}
+    bool need(size_t n) { if ((size_t)(end - p) < n) ok = false; return ok; }
+    uint8_t u8() { return need(1) ? *p++ : 0; }
+    uint16_t u16() { uint16_t lo = u8(); return (uint16_t)(lo | (u8() << 8)); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+    uint64_t u64() { uint64_t lo = u32(); return lo | ((uint64_t)u32() << 32); }
+    const uint8_t *raw(size_t n) {
+        if (!need(n)) return nullptr;
+        const uint8_t *r = p;
+        p += n;
+        return r;
+    }
+    void copy(void *dst, size_t n) {
+        const uint8_t *r = raw(n);
+        if (r) memcpy(dst, r, n);
+    }
+    bool str8(const char *expect) {
+        uint8_t n = u8();
+        const uint8_t *r = raw(n);
+        return r && n == strlen(expect) && memcmp(r, expect, n) == 0;
+    }
+};
+
+std::string entryFile(uint64_t hash) {
+    char name[48];
+    snprintf(name, sizeof(name), "/cartcache_%016llx.r8c", (unsigned long long)hash);
+    return name;
+}
+
+std::vector<uint64_t> readIndex(IReal8Host *host) {
+    std::vector<uint64_t> hashes;
+    std::vector<uint8_t> raw = host->loadState(INDEX_FILE);
+    if (raw.empty()) return hashes;
+    BlobReader r(raw);
+    if (r.u32() != INDEX_MAGIC || r.u16() != CACHE_VERSION) return hashes;
+    uint32_t count = r.u32();
+    for (uint32_t i = 0; i < count && r.ok; i++) {
+        uint64_t h = r.u64();
+        if (r.ok) hashes.push_back(h);
+    }
+    return hashes;
+}
+
+// Moves hash to the front of the LRU; entries pushed past MAX_ENTRIES are
+// deleted along with their files.
+void touchIndex(IReal8Host *host, uint64_t hash) {
+    std::vector<uint64_t> hashes = readIndex(host);
+    auto it = std::find(hashes.begin(), hashes.end(), hash);
+    if (it == hashes.begin() && it != hashes.end()) return; // already newest
+    if (it != hashes.end()) hashes.erase(it);
+    hashes.insert(hashes.begin(), hash);
+    while (hashes.size() > (size_t)Real8CartCache::MAX_ENTRIES) {
+        host->deleteFile(entryFile(hashes.back()).c_str());
+        hashes.pop_back();
+    }
+
+    BlobWriter w;
+    w.u32(INDEX_MAGIC);
+    w.u16(CACHE_VERSION);
+    w.u32((uint32_t)hashes.size());
+    for (uint64_t h : hashes) w.u64(h);
+    host->saveState(INDEX_FILE, w.out.data(), w.out.size());
+}
+
+bool readEntry(IReal8Host *host, uint64_t hash, GameData &out) {
+    std::vector<uint8_t> raw = host->loadState(entryFile(hash).c_str());
+    if (raw.empty()) return false;
+
+    BlobReader r(raw);
+    if (r.u32() != ENTRY_MAGIC || r.u16() != CACHE_VERSION) return false;
+    if (!r.str8(IReal8Host::REAL8_VERSION)) return false;
+    if (r.u64() != hash) return false;
+    uint64_t key = r.u64();
+
+    r.copy(out.gfx, sizeof(out.gfx));
+    r.copy(out.map, sizeof(out.map));
+    r.copy(out.sprite_flags, sizeof(out.sprite_flags));
+    r.copy(out.music, sizeof(out.music));
+    r.copy(out.sfx, sizeof(out.sfx));
+    uint32_t luaLen = r.u32();
+    const uint8_t *lua = r.raw(luaLen);
+    uint32_t chunkLen = r.u32();
+    const uint8_t *chunk = r.raw(chunkLen);
+    if (!r.ok || r.p != r.end) return false;
+
+    out.lua_code.assign((const char *)lua, luaLen);
+    out.lua_code_ptr = nullptr;
+    out.lua_code_size = 0;
+    out.cart_id = "";
+    out.content_hash = hash;
+    out.bytecode.assign(chunk, chunk + chunkLen);
+    out.bytecode_key = key;
+    return true;
+}
+
+} // namespace
+
+bool Real8CartCache::Load(IReal8Host *host, const uint8_t *data, size_t size, GameData &out, bool *hit)
+{
+    if (hit) *hit = false;
+    if (!data || size == 0) return false;
+
+    if (host) {
+        uint64_t hash = Real8CartLoader::ContentHash(data, size);
+        if (readEntry(host, hash, out)) {
+            if (hit) *hit = true;
+            touchIndex(host, hash);
+            return true;
+        }
+    }
+    return Real8CartLoader::LoadFromMemory(host, data, size, out);
+}
+
+void Real8CartCache::Store(IReal8Host *host, Real8VM *vm, const GameData &game)
+{
+    if (!host || !vm || !vm->cartBytecodeFresh || vm->cartBytecode.empty()) return;
+    if (game.content_hash == 0 || vm->cartBytecodeKey != vm->cartCodeKey(game)) return;
+    vm->cartBytecodeFresh = false;
+
+    const std::string &lua = game.lua_code;
+    BlobWriter w;
+    w.out.reserve(0x4400 + lua.size() + vm->cartBytecode.size() + 64);
+    w.u32(ENTRY_MAGIC);
+    w.u16(CACHE_VERSION);
+    w.str8(IReal8Host::REAL8_VERSION);
+    w.u64(game.content_hash);
+    w.u64(vm->cartBytecodeKey);
+    w.raw(game.gfx, sizeof(game.gfx));
+    w.raw(game.map, sizeof(game.map));
+    w.raw(game.sprite_flags, sizeof(game.sprite_flags));
+    w.raw(game.music, sizeof(game.music));
+    w.raw(game.sfx, sizeof(game.sfx));
+    w.u32((uint32_t)lua.size());
+    w.raw(lua.data(), lua.size());
+    w.u32((uint32_t)vm->cartBytecode.size());
+    w.raw(vm->cartBytecode.data(), vm->cartBytecode.size());
+
+    if (host->saveState(entryFile(game.content_hash).c_str(), w.out.data(), w.out.size())) {
+        touchIndex(host, game.content_hash);
+    }
+}
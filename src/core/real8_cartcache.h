@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "real8_cart.h"
+
+class IReal8Host;
+class Real8VM;
+
+// Content-addressed cache of parsed carts and their compiled Lua.
+//
+// Entries are keyed by the FNV-1a hash of the raw cart file and hold the
+// decoded memory sections, the Lua source and the chunk lua_dump produced
+// for it, so relaunching a cart skips the PNG/PXA decode and the parser.
+// Each entry lives in its own file in the host's save directory;
+// cartcache.idx keeps them in LRU order and the oldest are deleted past
+// MAX_ENTRIES. A different Real8 build or Lua chunk layout invalidates
+// every entry.
+class Real8CartCache {
+public:
+    static const int MAX_ENTRIES = 16;
+
+    // Fills out from the cache when these bytes were seen before, otherwise
+    // parses them with Real8CartLoader. *hit (optional) reports which.
+    static bool Load(IReal8Host* host, const uint8_t* data, size_t size, GameData& out, bool* hit = nullptr);
+
+    // Persists the chunk the VM compiled for game. Cheap no-op unless the
+    // last loadGame actually had to compile.
+    static void Store(IReal8Host* host, Real8VM* vm, const GameData& game);
+};
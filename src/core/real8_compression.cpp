@@ -184,11 +184,119 @@ static int decompress_legacy(IReal8Host *host, const uint8_t *input, int in_len,
 // --------------------------------------------------------------------------
 // PXA DECOMPRESSOR
 // --------------------------------------------------------------------------
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define REAL8_PXA_WORD_OPS 0
+#else
+#define REAL8_PXA_WORD_OPS 1
+#endif
+
+// LSB-first like BitReader, but refilled a whole 64-bit word at a time.
+// Reads past the end of the input yield zero bits.
+struct BitReader64
+{
+    const uint8_t *src;
+    const uint8_t *end;
+    uint64_t bits;
+    int count;
+
+    BitReader64(const uint8_t *s, int l) : src(s), end(s + (l > 0 ? l : 0)), bits(0), count(0) {}
+
+    // Tops the buffer up to at least 56 bits.
+    inline void refill()
+    {
+#if REAL8_PXA_WORD_OPS
+        if (end - src >= 8)
+        {
+            uint64_t w;
+            memcpy(&w, src, 8);
+            // Bytes past the ones consumed here land in the same place next time.
+            bits |= w << count;
+            src += (63 - count) >> 3;
+            count |= 56;
+            return;
+        }
+#endif
+        while (count <= 56 && src < end)
+        {
+            bits |= (uint64_t)*src++ << count;
+            count += 8;
+        }
+        if (src >= end)
+            count = 64; // everything above is zero padding
+    }
+
+    inline uint32_t peek(int n) const { return (uint32_t)(bits & ((1ULL << n) - 1)); }
+    inline void consume(int n)
+    {
+        bits >>= n;
+        count -= n;
+    }
+    inline uint32_t read(int n)
+    {
+        if (count < n)
+            refill();
+        uint32_t v = peek(n);
+        consume(n);
+        return v;
+    }
+};
+
+// Number of consecutive 1 bits from the LSB of a byte (the literal's
+// unary length prefix).
+static const uint8_t pxa_trailing_ones[256] = {
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,6,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,7,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,6,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,5,
+    0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,8,
+};
+
+// Block header bits (including the 0 flag), indexed by the two bits after it:
+// "0" -> 15 offset bits, "10" -> 10, "11" -> 5 (LSB first).
+static const uint8_t pxa_offset_bits[4] = {15, 10, 15, 5};
+static const uint8_t pxa_header_bits[4] = {2, 3, 2, 3};
+
+// Moves mtf[idx] to the front. The first 16 entries (every 4-bit literal)
+// are shifted as two 64-bit words instead of a byte-wise memmove.
+static inline uint8_t pxa_mtf_take(uint8_t *mtf, int idx)
+{
+    uint8_t val = mtf[idx];
+#if REAL8_PXA_WORD_OPS
+    if (idx < 16)
+    {
+        uint64_t w0, w1;
+        memcpy(&w0, mtf, 8);
+        if (idx < 8)
+        {
+            uint64_t m = (idx == 7) ? ~0ULL : ((1ULL << (8 * (idx + 1))) - 1);
+            w0 = (w0 & ~m) | (((w0 << 8) | val) & m);
+        }
+        else
+        {
+            memcpy(&w1, mtf + 8, 8);
+            uint64_t m = (idx == 15) ? ~0ULL : ((1ULL << (8 * (idx - 7))) - 1);
+            w1 = (w1 & ~m) | (((w1 << 8) | (w0 >> 56)) & m);
+            w0 = (w0 << 8) | val;
+            memcpy(mtf + 8, &w1, 8);
+        }
+        memcpy(mtf, &w0, 8);
+        return val;
+    }
+#endif
+    memmove(mtf + 1, mtf, idx);
+    mtf[0] = val;
+    return val;
+}
+
 static int decompress_pxa(IReal8Host *host, const uint8_t *input, int in_len, char *output, int out_max)
 {
     if (in_len < 8)
         return -1;
-    host->log("PXA COMPRESSION FOUND!");
+    if (host) host->log("PXA COMPRESSION FOUND!");
 
     int dest_len = (input[4] << 8) | input[5];
     if (dest_len > out_max - 1)
@@ -198,15 +306,17 @@ static int decompress_pxa(IReal8Host *host, const uint8_t *input, int in_len, ch
     for (int i = 0; i < 256; ++i)
         mtf[i] = (uint8_t)i;
 
-    BitReader br(input + 8, in_len - 8);
+    BitReader64 br(input + 8, in_len - 8);
     int op = 0;
-    unsigned long last_yield = host->getMillis();
+    int next_yield_check = 0;
+    unsigned long last_yield = host ? host->getMillis() : 0;
 
     while (op < dest_len)
     {
-        // IMPROVEMENT 1: Only check system timer every 2048 operations
-        if ((op & 2047) == 0)
+        // Check the system timer roughly every 2048 output bytes
+        if (host && op >= next_yield_check)
         {
+            next_yield_check = op + 2048;
             if (host->getMillis() - last_yield > 10)
             {
                 host->delayMs(0);
@@ -214,92 +324,91 @@ static int decompress_pxa(IReal8Host *host, const uint8_t *input, int in_len, ch
             }
         }
 
-        if (br.read(1))
+        // Enough for any literal or block header + offset (<= 18 bits)
+        if (br.count < 32)
+            br.refill();
+        uint32_t head = br.peek(9);
+
+        if (head & 1)
         {
-            // Literal Logic
-            int nbits = 4;
-            while (br.read(1))
+            // Literal: 1, unary prefix, 0, then nbits of MTF index
+            int ones = pxa_trailing_ones[head >> 1];
+            int nbits = 4 + ones;
+            int idx = 256; // nbits > 8 can only produce indices >= 496
+            if (nbits <= 8)
             {
-                nbits++;
-                if (nbits > 16)
-                    return -1; // Safety against infinite 1s
+                br.consume(ones + 2);
+                idx = (int)br.peek(nbits) + (1 << nbits) - 16;
+                br.consume(nbits);
             }
-            int idx = br.read(nbits) + (1 << nbits) - 16;
-
-            // IMPROVEMENT 2: Validate index
             if (idx > 255)
             {
-                host->log("[PXA] Corrupt Literal");
+                if (host) host->log("[PXA] Corrupt Literal");
                 return -1;
             }
-
-            uint8_t val = mtf[idx];
-
-            // IMPROVEMENT 3: memmove for clarity/speed
-            if (idx > 0)
-            {
-                memmove(mtf + 1, mtf, idx);
-            }
-            mtf[0] = val;
-            output[op++] = (char)val;
+            output[op++] = (char)pxa_mtf_take(mtf, idx);
+            continue;
         }
-        else
-        {
-            // Block Logic
-            int offset_bits;
-            if (br.read(1))
-            {
-                if (br.read(1))
-                    offset_bits = 5;
-                else
-                    offset_bits = 10;
-            }
-            else
-            {
-                offset_bits = 15;
-            }
 
-            int offset = br.read(offset_bits) + 1;
+        // Block
+        int sel = (head >> 1) & 3;
+        int offset_bits = pxa_offset_bits[sel];
+        br.consume(pxa_header_bits[sel]);
+        int offset = (int)br.peek(offset_bits) + 1;
+        br.consume(offset_bits);
 
-            // Raw Block (Official specific check)
-            if (offset_bits == 10 && offset == 1)
+        // Raw Block (Official specific check)
+        if (offset_bits == 10 && offset == 1)
+        {
+            while (true)
             {
-                while (true)
-                {
-                    uint8_t val = (uint8_t)br.read(8);
-                    if (val == 0)
-                        break;
-                    if (op < dest_len)
-                        output[op++] = (char)val;
-                }
-                continue;
+                uint8_t val = (uint8_t)br.read(8);
+                if (val == 0)
+                    break;
+                if (op < dest_len)
+                    output[op++] = (char)val;
             }
+            continue;
+        }
 
-            int len = 3;
-            int part;
-            do
-            {
-                part = br.read(3);
-                len += part;
-            } while (part == 7 && op + len < dest_len); // Add bounds check to loop
+        int len = 3;
+        int part;
+        do
+        {
+            part = (int)br.read(3);
+            len += part;
+        } while (part == 7 && op + len < dest_len);
 
-            int src = op - offset;
-            if (src < 0)
-                src = 0; // Safety clamp
+        int src = op - offset;
+        if (src < 0)
+            src = 0; // Safety clamp
 
-            // Optimization: if offset is 1 (RLE), memset is faster
-            if (offset == 1)
-            {
-                int run = std::min(len, dest_len - op);
-                memset(output + op, output[src], run);
-                op += run;
-            }
-            else
+        int run = std::min(len, dest_len - op);
+        int dist = op - src;
+        if (offset == 1)
+        {
+            memset(output + op, output[src], run);
+            op += run;
+        }
+        else if (dist >= 8)
+        {
+            // Source trails by at least a word, so 8-byte chunks never read
+            // bytes written by the same chunk.
+            char *d = output + op;
+            const char *s = output + src;
+            int i = 0;
+            for (; i + 8 <= run; i += 8)
+                memcpy(d + i, s + i, 8);
+            for (; i < run; ++i)
+                d[i] = s[i];
+            op += run;
+        }
+        else
+        {
+            for (int i = 0; i < run; ++i)
             {
-                for (int i = 0; i < len && op < dest_len; ++i)
-                {
-                    output[op++] = output[src + i];
-                }
+                output[op] = output[src + i];
+                op++;
             }
         }
     }
@@ -352,6 +461,270 @@ int decompress_pico8_code(IReal8Host *host, const uint8_t *input, int in_len, ch
         return copy_len;
     }
 
-    host->log("[REAL8-ERROR] Unknown compression format.");
+    if (host) host->log("[REAL8-ERROR] Unknown compression format.");
     return -1;
-}
\ No newline at end of file
+}
+
+// --------------------------------------------------------------------------
+// PXA COMPRESSOR
+// --------------------------------------------------------------------------
+
+namespace {
+
+const int PXA_WINDOW = 32768;
+const int PXA_MIN_MATCH = 3;
+const int PXA_HASH_BITS = 13;
+
+struct PxaBitWriter
+{
+    std::vector<uint8_t> bytes;
+    uint32_t acc = 0;
+    int count = 0;
+
+    void write(uint32_t value, int n)
+    {
+        acc |= (value & ((1u << n) - 1)) << count;
+        count += n;
+        while (count >= 8)
+        {
+            bytes.push_back((uint8_t)acc);
+            acc >>= 8;
+            count -= 8;
+        }
+    }
+
+    void flush()
+    {
+        if (count > 0)
+            bytes.push_back((uint8_t)acc);
+        acc = 0;
+        count = 0;
+    }
+};
+
+// Literal size for MTF index idx: 1, unary (nbits - 4), 0, nbits.
+inline int pxa_literal_bits(int idx)
+{
+    if (idx < 16) return 6;
+    if (idx < 48) return 8;
+    if (idx < 112) return 10;
+    if (idx < 240) return 12;
+    return 14;
+}
+
+inline int pxa_match_bits(int len, int offset)
+{
+    int bits = offset <= 32 ? 8 : (offset <= 1024 ? 13 : 17);
+    return bits + 3 * ((len - PXA_MIN_MATCH) / 7 + 1);
+}
+
+inline uint32_t pxa_hash(const uint8_t *p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (v * 2654435761u) >> (32 - PXA_HASH_BITS);
+}
+
+struct PxaEncoder
+{
+    const uint8_t *in;
+    int n;
+    int maxChain;
+    bool lazy;
+
+    std::vector<int32_t> head;
+    std::vector<int32_t> prev;
+    int inserted = 0;
+
+    uint8_t mtf[256];
+    uint8_t where[256]; // inverse of mtf
+    PxaBitWriter bw;
+
+    PxaEncoder(const uint8_t *input, int len, PxaLevel level)
+        : in(input), n(len),
+          maxChain(level == PxaLevel::Fast ? 16 : 4096),
+          lazy(level != PxaLevel::Fast),
+          head((size_t)1 << PXA_HASH_BITS, -1), prev((size_t)len, -1)
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            mtf[i] = (uint8_t)i;
+            where[i] = (uint8_t)i;
+        }
+    }
+
+    void insertUpTo(int pos)
+    {
+        for (; inserted < pos && inserted + PXA_MIN_MATCH <= n; ++inserted)
+        {
+            uint32_t h = pxa_hash(in + inserted);
+            prev[inserted] = head[h];
+            head[h] = inserted;
+        }
+    }
+
+    // Bits saved by covering len bytes at pos with a match instead of
+    // literals, pricing literals at their current MTF positions.
+    int savings(int pos, int len, int offset) const
+    {
+        int lit = 0;
+        int priced = std::min(len, 32);
+        for (int i = 0; i < priced; ++i)
+            lit += pxa_literal_bits(where[in[pos + i]]);
+        lit += (len - priced) * 6;
+        return lit - pxa_match_bits(len, offset);
+    }
+
+    // Best match at pos by estimated savings; returns its length (0 = none).
+    int findMatch(int pos, int &bestOffset)
+    {
+        insertUpTo(pos);
+        int maxLen = n - pos;
+        if (maxLen < PXA_MIN_MATCH)
+            return 0;
+
+        int bestLen = 0;
+        int bestScore = 0;
+        int chain = maxChain;
+        for (int cand = head[pxa_hash(in + pos)]; cand >= 0 && chain-- > 0; cand = prev[cand])
+        {
+            int offset = pos - cand;
+            if (offset > PXA_WINDOW)
+                break;
+            // Quick reject: must beat the current best length to be interesting.
+            if (bestLen > 0 && (bestLen >= maxLen || in[cand + bestLen] != in[pos + bestLen]))
+                continue;
+            int len = 0;
+            while (len < maxLen && in[cand + len] == in[pos + len])
+                ++len;
+            if (len < PXA_MIN_MATCH)
+                continue;
+            // Approximate score while searching: ~7 bits per literal.
+            int score = len * 7 - pxa_match_bits(len, offset);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestLen = len;
+                bestOffset = offset;
+                if (len == maxLen)
+                    break;
+            }
+        }
+        return bestLen;
+    }
+
+    void emitLiteral(uint8_t b)
+    {
+        int idx = where[b];
+        int nbits = 4;
+        while (idx >= (1 << nbits) - 16 + (1 << nbits))
+            ++nbits;
+        bw.write(1, 1);
+        bw.write((1u << (nbits - 4)) - 1, nbits - 4);
+        bw.write(0, 1);
+        bw.write((uint32_t)(idx - ((1 << nbits) - 16)), nbits);
+
+        memmove(mtf + 1, mtf, idx);
+        mtf[0] = b;
+        for (int i = 0; i <= idx; ++i)
+            where[mtf[i]] = (uint8_t)i;
+    }
+
+    void emitMatch(int pos, int len, int offset)
+    {
+        bw.write(0, 1);
+        int v = offset - 1;
+        if (v < 32)
+        {
+            bw.write(1, 1);
+            bw.write(1, 1);
+            bw.write((uint32_t)v, 5);
+        }
+        else if (v < 1024)
+        {
+            bw.write(1, 1);
+            bw.write(0, 1);
+            bw.write((uint32_t)v, 10);
+        }
+        else
+        {
+            bw.write(0, 1);
+            bw.write((uint32_t)v, 15);
+        }
+
+        // Mirrors the decoder: another 3-bit part follows a 7 unless the
+        // length so far already reaches the end of the output.
+        int rem = len - PXA_MIN_MATCH;
+        int cur = PXA_MIN_MATCH;
+        while (true)
+        {
+            int part = std::min(rem, 7);
+            bw.write((uint32_t)part, 3);
+            rem -= part;
+            cur += part;
+            if (part != 7 || pos + cur >= n)
+                break;
+        }
+    }
+
+    void run()
+    {
+        int pos = 0;
+        while (pos < n)
+        {
+            int offset = 0;
+            int len = findMatch(pos, offset);
+            if (len > 0 && savings(pos, len, offset) <= 0)
+                len = 0;
+
+            if (len > 0 && lazy && pos + 1 < n)
+            {
+                // Defer by one byte if the next position has a clearly better match.
+                int nextOffset = 0;
+                int nextLen = findMatch(pos + 1, nextOffset);
+                if (nextLen > len && savings(pos + 1, nextLen, nextOffset) > savings(pos, len, offset))
+                    len = 0;
+            }
+
+            if (len > 0)
+            {
+                emitMatch(pos, len, offset);
+                pos += len;
+            }
+            else
+            {
+                emitLiteral(in[pos]);
+                pos++;
+            }
+        }
+        bw.flush();
+    }
+};
+
+} // namespace
+
+bool compress_pico8_code_pxa(const uint8_t *input, int in_len, std::vector<uint8_t> &output, PxaLevel level)
+{
+    output.clear();
+    if (in_len < 0 || in_len > 0xFFFF || (in_len > 0 && !input))
+        return false;
+
+    PxaEncoder enc(input, in_len, level);
+    enc.run();
+
+    size_t total = 8 + enc.bw.bytes.size();
+    if (total > 0xFFFF)
+        return false;
+
+    // Both lengths big-endian; the compressed one includes this header.
+    output.reserve(total);
+    output.push_back(0x00);
+    output.push_back('p');
+    output.push_back('x');
+    output.push_back('a');
+    output.push_back((uint8_t)(in_len >> 8));
+    output.push_back((uint8_t)in_len);
+    output.push_back((uint8_t)(total >> 8));
+    output.push_back((uint8_t)total);
+    output.insert(output.end(), enc.bw.bytes.begin(), enc.bw.bytes.end());
+    return true;
+}
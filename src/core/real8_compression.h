@@ -2,9 +2,20 @@
 #define REAL8_COMPRESSION_H
 
 #include <stdint.h>
+#include <vector>
 #include "../hal/real8_host.h"
 
 // Decompresses PICO-8 code into a raw buffer.
+// host may be null (worker threads); logging and yielding are skipped then.
 int decompress_pico8_code(IReal8Host* host, const uint8_t* input, int in_len, char* output, int out_max);
 
+enum class PxaLevel {
+    Fast,   // short hash chains, greedy parse: interactive export
+    Best    // long chains plus one-step lazy matching: smallest output
+};
+
+// Compresses Lua source into a PXA code block, 8-byte header included.
+// Fails if the source exceeds 0xFFFF bytes.
+bool compress_pico8_code_pxa(const uint8_t* input, int in_len, std::vector<uint8_t>& output, PxaLevel level);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,482 @@
+#include "real8_library.h"
+#include "real8_cart.h"
+#include "real8_compression.h"
+#include "../hal/real8_host.h"
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+// --------------------------------------------------------------------------
+// INDEX FORMAT
+// --------------------------------------------------------------------------
+// library.idx: "R8LI" | u16 version | u32 count | entries
+//   entry: str16 path | u64 size | u64 mtime | str8 title | str8 author |
+//          u8 fps | u8 flags | i32 label slot
+// library.lbl: LABEL_BYTES per slot, low nibble = even x (like gfx memory)
+
+namespace {
+
+const char *INDEX_FILE = "/library.idx";
+const char *LABEL_FILE = "/library.lbl";
+const uint32_t INDEX_MAGIC = 0x494C3852; // "R8LI"
+const uint16_t INDEX_VERSION = 2; // 2: .p8 carts carry labels
+const uint8_t FLAG_SCANNED = 1;
+
+struct IndexWriter {
+    std::vector<uint8_t> out;
+    void u8(uint8_t v) { out.push_back(v); }
+    void u16(uint16_t v) { u8((uint8_t)v); u8((uint8_t)(v >> 8)); }
+    void u32(uint32_t v) { u16((uint16_t)v); u16((uint16_t)(v >> 16)); }
+    void u64(uint64_t v) { u32((uint32_t)v); u32((uint32_t)(v >> 32)); }
+    void str16(const std::string &s) {
+        size_t n = std::min<size_t>(s.size(), 0xFFFF);
+        u16((uint16_t)n);
+        out.insert(out.end(), s.begin(), s.begin() + n);
+    }
+    void str8(const std::string &s) {
+        size_t n = std::min<size_t>(s.size(), 0xFF);
+        u8((uint8_t)n);
+        out.insert(out.end(), s.begin(), s.begin() + n);
+    }
+};
+
+struct IndexReader {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool ok = true;
+    IndexReader(const std::vector<uint8_t> &v) : p(v.data()), end(v.data() + v.size()) {}
+    bool need(size_t n) { if ((size_t)(end - p) < n) ok = false; return ok; }
+    uint8_t u8() { return need(1) ? *p++ : 0; }
+    uint16_t u16() { uint16_t lo = u8(); return (uint16_t)(lo | (u8() << 8)); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+    uint64_t u64() { uint64_t lo = u32(); return lo | ((uint64_t)u32() << 32); }
+    std::string bytes(size_t n) {
+        if (!need(n)) return std::string();
+        std::string s((const char *)p, n);
+        p += n;
+        return s;
+    }
+    std::string str16() { return bytes(u16()); }
+    std::string str8() { return bytes(u8()); }
+};
+
+bool endsWith(const std::string &s, const char *suffix) {
+    size_t len = strlen(suffix);
+    return s.length() >= len && s.compare(s.length() - len, len, suffix) == 0;
+}
+
+// PICO-8 convention: the first two "--" comment lines name the cart and author.
+void parseCodeMetadata(const char *code, size_t len, LibraryEntry &e) {
+    std::string lines[2];
+    int found = 0;
+    size_t pos = 0;
+    while (pos < len && found < 2) {
+        size_t eol = pos;
+        while (eol < len && code[eol] != '\n') eol++;
+        size_t a = pos, b = eol;
+        while (a < b && (code[a] == ' ' || code[a] == '\t' || code[a] == '\r')) a++;
+        while (b > a && (code[b - 1] == ' ' || code[b - 1] == '\t' || code[b - 1] == '\r')) b--;
+        if (b - a >= 2 && code[a] == '-' && code[a + 1] == '-') {
+            a += 2;
+            while (a < b && (code[a] == ' ' || code[a] == '-')) a++;
+            while (b > a && (code[b - 1] == ' ' || code[b - 1] == '-')) b--;
+            lines[found++] = std::string(code + a, b - a);
+        } else if (b > a) {
+            break; // code started before any header comment
+        }
+        pos = eol + 1;
+    }
+    e.title = lines[0];
+    e.author = lines[1];
+
+    static const char KEY[] = "_update60";
+    e.fps = std::search(code, code + len, KEY, KEY + sizeof(KEY) - 1) != code + len ? 60 : 30;
+}
+
+} // namespace
+
+// --------------------------------------------------------------------------
+// PERSISTENCE
+// --------------------------------------------------------------------------
+
+void Real8Library::load(IReal8Host *host)
+{
+    if (loaded || !host) return;
+    loaded = true;
+    entries.clear();
+    freeSlots.clear();
+    slotCount = 0;
+
+    std::vector<uint8_t> raw = host->loadState(INDEX_FILE);
+    if (raw.empty()) return;
+
+    IndexReader r(raw);
+    if (r.u32() != INDEX_MAGIC || r.u16() != INDEX_VERSION) return;
+    uint32_t count = r.u32();
+
+    std::map<std::string, LibraryEntry> parsed;
+    for (uint32_t i = 0; i < count && r.ok; i++) {
+        LibraryEntry e;
+        e.path = r.str16();
+        e.size = r.u64();
+        e.mtime = r.u64();
+        e.title = r.str8();
+        e.author = r.str8();
+        e.fps = r.u8();
+        e.scanned = (r.u8() & FLAG_SCANNED) != 0;
+        e.labelSlot = (int32_t)r.u32();
+        if (!r.ok) break;
+        parsed[e.path] = e;
+    }
+    if (!r.ok) return; // truncated: start over rather than trust half an index
+
+    std::set<int32_t> used;
+    for (auto &kv : parsed) {
+        LibraryEntry &e = kv.second;
+        if (e.labelSlot < 0 || used.count(e.labelSlot)) { e.labelSlot = -1; continue; }
+        used.insert(e.labelSlot);
+        slotCount = std::max(slotCount, e.labelSlot + 1);
+    }
+    for (int32_t s = 0; s < slotCount; s++) {
+        if (!used.count(s)) freeSlots.push_back(s);
+    }
+    entries.swap(parsed);
+}
+
+void Real8Library::save(IReal8Host *host)
+{
+    if (!dirty || !host) return;
+
+    IndexWriter w;
+    w.u32(INDEX_MAGIC);
+    w.u16(INDEX_VERSION);
+    w.u32((uint32_t)entries.size());
+    for (const auto &kv : entries) {
+        const LibraryEntry &e = kv.second;
+        w.str16(e.path);
+        w.u64(e.size);
+        w.u64(e.mtime);
+        w.str8(e.title);
+        w.str8(e.author);
+        w.u8(e.fps);
+        w.u8(e.scanned ? FLAG_SCANNED : 0);
+        w.u32((uint32_t)e.labelSlot);
+    }
+    if (host->saveState(INDEX_FILE, w.out.data(), w.out.size())) dirty = false;
+}
+
+// --------------------------------------------------------------------------
+// SCANNING
+// --------------------------------------------------------------------------
+
+int32_t Real8Library::allocSlot()
+{
+    if (!freeSlots.empty()) {
+        int32_t s = freeSlots.back();
+        freeSlots.pop_back();
+        return s;
+    }
+    return slotCount++;
+}
+
+void Real8Library::releaseSlot(LibraryEntry &e)
+{
+    if (e.labelSlot >= 0) freeSlots.push_back(e.labelSlot);
+    e.labelSlot = -1;
+}
+
+void Real8Library::sync(IReal8Host *host, const std::vector<std::string> &paths)
+{
+    load(host);
+
+    std::set<std::string> present(paths.begin(), paths.end());
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (!present.count(it->first)) {
+            releaseSlot(it->second);
+            it = entries.erase(it);
+            dirty = true;
+        } else {
+            ++it;
+        }
+    }
+
+    for (const std::string &path : paths) {
+        auto it = entries.find(path);
+        if (it == entries.end()) {
+            LibraryEntry e;
+            e.path = path;
+            entries[path] = e;
+            dirty = true;
+        }
+    }
+}
+
+const LibraryEntry *Real8Library::find(const std::string &path) const
+{
+    auto it = entries.find(path);
+    return (it == entries.end()) ? nullptr : &it->second;
+}
+
+bool Real8Library::hasLabel(const std::string &path) const
+{
+    const LibraryEntry *e = find(path);
+    return e && e->scanned && e->labelSlot >= 0;
+}
+
+void Real8Library::scanData(const uint8_t *data, size_t size, Real8PngCart::ColorMapFn mapColor, LibraryScan &out)
+{
+    LibraryEntry meta;
+    out.hasLabel = false;
+
+    if (endsWith(out.path, ".png")) {
+        std::vector<uint8_t> cart(0x8000);
+        std::vector<uint8_t> label(128 * 128);
+        uint8_t (*rows)[128] = (uint8_t (*)[128])label.data();
+        size_t cartLen = 0;
+        if (Real8PngCart::Decode(data, size, cart.data(), cart.size(), &cartLen, rows, mapColor)) {
+            out.hasLabel = true;
+            packLabel(rows, out.label);
+            if (cartLen >= 0x4300) {
+                std::vector<char> code(65536);
+                int codeLen = decompress_pico8_code(nullptr, cart.data() + 0x4300, 0x8000 - 0x4300, code.data(), (int)code.size());
+                if (codeLen > 0) parseCodeMetadata(code.data(), (size_t)codeLen, meta);
+            }
+        }
+    } else if (data && size > 0) {
+        P8TextSections sections;
+        Real8CartLoader::SplitTextSections((const char *)data, size, sections);
+        if (!sections.lua.empty()) parseCodeMetadata(sections.lua.data(), sections.lua.size(), meta);
+        std::vector<uint8_t> label(128 * 128);
+        uint8_t (*rows)[128] = (uint8_t (*)[128])label.data();
+        if (Real8CartLoader::DecodeTextLabel(sections.label, rows)) {
+            out.hasLabel = true;
+            packLabel(rows, out.label);
+        }
+    }
+
+    out.title = meta.title;
+    out.author = meta.author;
+    out.fps = meta.fps;
+}
+
+void Real8Library::packLabel(const uint8_t (*label)[128], uint8_t *packed)
+{
+    for (int y = 0; y < 128; y++) {
+        for (int x = 0; x < 128; x += 2) {
+            packed[y * 64 + x / 2] = (uint8_t)((label[y][x] & 0x0F) | ((label[y][x + 1] & 0x0F) << 4));
+        }
+    }
+}
+
+void Real8Library::unpackLabel(const uint8_t *packed, uint8_t (*labelOut)[128])
+{
+    for (int y = 0; y < 128; y++) {
+        for (int x = 0; x < 128; x += 2) {
+            uint8_t v = packed[y * 64 + x / 2];
+            labelOut[y][x] = v & 0x0F;
+            labelOut[y][x + 1] = v >> 4;
+        }
+    }
+}
+
+void Real8Library::store(IReal8Host *host, const LibraryScan &scan)
+{
+    auto it = entries.find(scan.path);
+    if (it == entries.end()) return; // dropped by a later sync
+    LibraryEntry &e = it->second;
+    if (!scan.changed) return;
+
+    // A preview request and the background sweep can both scan one cart.
+    if (scan.haveInfo && e.scanned && e.size == scan.size && e.mtime == scan.mtime) return;
+
+    e.size = scan.size;
+    e.mtime = scan.mtime;
+    e.title = scan.title;
+    e.author = scan.author;
+    e.fps = scan.fps;
+    if (scan.hasLabel) {
+        if (e.labelSlot < 0) e.labelSlot = allocSlot();
+        if (!host->writeFileRange(LABEL_FILE, (size_t)e.labelSlot * LABEL_BYTES, scan.label, LABEL_BYTES)) {
+            releaseSlot(e);
+        }
+    } else {
+        releaseSlot(e);
+    }
+    // Without size/mtime the next session has to look at the cart again.
+    e.scanned = scan.haveInfo;
+    dirty = true;
+}
+
+bool Real8Library::readLabel(IReal8Host *host, const LibraryEntry &e, uint8_t (*labelOut)[128]) const
+{
+    if (!e.scanned || e.labelSlot < 0) return false;
+    uint8_t packed[LABEL_BYTES];
+    if (!host->readFileRange(LABEL_FILE, (size_t)e.labelSlot * LABEL_BYTES, packed, LABEL_BYTES)) return false;
+    unpackLabel(packed, labelOut);
+    return true;
+}
+
+// --------------------------------------------------------------------------
+// LABEL CACHE
+// --------------------------------------------------------------------------
+
+void Real8LabelCache::setBudget(size_t bytes)
+{
+    budget = bytes;
+    trim();
+}
+
+bool Real8LabelCache::get(const std::string &key, uint8_t (*labelOut)[128], bool &hasLabel)
+{
+    auto it = index.find(key);
+    if (it == index.end()) return false;
+    lru.splice(lru.begin(), lru, it->second);
+    const Node &n = *it->second;
+    hasLabel = !n.packed.empty();
+    if (hasLabel && labelOut) Real8Library::unpackLabel(n.packed.data(), labelOut);
+    return true;
+}
+
+void Real8LabelCache::put(const std::string &key, const uint8_t *packed)
+{
+    auto it = index.find(key);
+    if (it != index.end()) {
+        used -= cost(*it->second);
+        lru.erase(it->second);
+        index.erase(it);
+    }
+
+    Node n;
+    n.key = key;
+    if (packed) n.packed.assign(packed, packed + Real8Library::LABEL_BYTES);
+    used += cost(n);
+    lru.push_front(std::move(n));
+    index[key] = lru.begin();
+    trim();
+}
+
+void Real8LabelCache::clear()
+{
+    lru.clear();
+    index.clear();
+    used = 0;
+}
+
+void Real8LabelCache::trim()
+{
+    // Always keep the newest entry, even if it alone exceeds the budget.
+    while (used > budget && lru.size() > 1) {
+        const Node &n = lru.back();
+        used -= cost(n);
+        index.erase(n.key);
+        lru.pop_back();
+    }
+}
+
+// --------------------------------------------------------------------------
+// BACKGROUND SCANNER
+// --------------------------------------------------------------------------
+
+Real8LibraryScanner::Real8LibraryScanner(IReal8Host *h, Real8PngCart::ColorMapFn map, int threads)
+    : host(h), mapColor(map)
+{
+    if (threads < 1) threads = 1;
+    for (int i = 0; i < threads; i++) workers.emplace_back(&Real8LibraryScanner::workerLoop, this);
+}
+
+Real8LibraryScanner::~Real8LibraryScanner()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (auto &t : workers) {
+        if (t.joinable()) t.join();
+    }
+
+    Job *job = nullptr;
+    while (previewJobs.pop(job)) delete job;
+    while (scanJobs.pop(job)) delete job;
+    LibraryScan *res = nullptr;
+    while (results.pop(res)) delete res;
+}
+
+bool Real8LibraryScanner::submit(const LibraryEntry &e, bool preview)
+{
+    Job *job = new Job{ e.path, e.size, e.mtime, e.scanned, preview,
+                        preview ? previewGeneration.load() : scanGeneration.load() };
+    inFlight.fetch_add(1);
+    bool ok = preview ? previewJobs.push(job) : scanJobs.push(job);
+    if (!ok) {
+        inFlight.fetch_sub(1);
+        delete job;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queued.fetch_add(1);
+    }
+    wake.notify_one();
+    return true;
+}
+
+void Real8LibraryScanner::cancelPreviews() { previewGeneration.fetch_add(1); }
+
+void Real8LibraryScanner::cancelAll()
+{
+    previewGeneration.fetch_add(1);
+    scanGeneration.fetch_add(1);
+}
+
+bool Real8LibraryScanner::stale(const Job &job) const
+{
+    uint32_t current = job.preview ? previewGeneration.load() : scanGeneration.load();
+    return job.generation != current || stopping.load();
+}
+
+std::unique_ptr<LibraryScan> Real8LibraryScanner::poll()
+{
+    LibraryScan *res = nullptr;
+    if (!results.pop(res)) return nullptr;
+    return std::unique_ptr<LibraryScan>(res);
+}
+
+void Real8LibraryScanner::workerLoop()
+{
+    for (;;) {
+        Job *job = nullptr;
+        if (!previewJobs.pop(job) && !scanJobs.pop(job)) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+            if (stopping.load()) return;
+            continue;
+        }
+        queued.fetch_sub(1);
+        std::unique_ptr<Job> owned(job);
+
+        std::unique_ptr<LibraryScan> res;
+        if (!stale(*job)) {
+            res.reset(new LibraryScan());
+            res->path = job->path;
+            res->haveInfo = host->getFileInfo(job->path.c_str(), res->size, res->mtime);
+            if (res->haveInfo && job->scanned && res->size == job->size && res->mtime == job->mtime) {
+                res->changed = false;
+            } else {
+                MappedFile data(host, job->path.c_str());
+                if (stale(*job)) res.reset();
+                else Real8Library::scanData(data.data(), data.size(), mapColor, *res);
+            }
+        }
+
+        // Finished work is still valid after a cancel, so hand it over anyway.
+        if (res) {
+            LibraryScan *out = res.release();
+            while (!results.push(out)) {
+                if (stopping.load()) { delete out; out = nullptr; break; }
+                std::this_thread::yield();
+            }
+        }
+        inFlight.fetch_sub(1);
+    }
+}
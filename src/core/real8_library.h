@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "real8_png.h"
+
+class IReal8Host;
+
+// One local cart as last seen by the library scan.
+struct LibraryEntry {
+    std::string path;        // virtual path, e.g. "/folder/cart.p8.png"
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+    std::string title;       // first "--" comment line of the code
+    std::string author;      // second "--" comment line of the code
+    uint8_t fps = 30;        // 60 when the cart defines _update60
+    bool scanned = false;    // metadata/label have been extracted
+    int32_t labelSlot = -1;  // slot in library.lbl, -1 = no label
+};
+
+// Result of scanning one cart; produced off the UI thread.
+struct LibraryScan {
+    static const int LABEL_BYTES = 128 * 128 / 2;
+
+    std::string path;
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+    bool haveInfo = false;   // host reported size/mtime
+    bool changed = true;     // false: matched the index, nothing was decoded
+    std::string title;
+    std::string author;
+    uint8_t fps = 30;
+    bool hasLabel = false;
+    uint8_t label[LABEL_BYTES]; // 4bpp, low nibble = even x
+};
+
+// Persistent index of the local cart library.
+//
+// library.idx holds the per-cart metadata and is loaded whole; labels live
+// in fixed 4bpp slots inside library.lbl and are read one at a time, so the
+// resident cost stays small even for folders with thousands of carts.
+// sync() only reconciles the listing; entries are revalidated against the
+// host's size/mtime by Real8LibraryScanner and only changed carts are
+// decoded again.
+class Real8Library {
+public:
+    static const int LABEL_BYTES = LibraryScan::LABEL_BYTES;
+
+    void load(IReal8Host* host);
+    void save(IReal8Host* host);
+
+    // Reconciles the index with the current listing: vanished carts are
+    // dropped, new ones added unscanned.
+    void sync(IReal8Host* host, const std::vector<std::string>& paths);
+
+    const LibraryEntry* find(const std::string& path) const;
+    bool hasLabel(const std::string& path) const;
+
+    // Thread-safe: extracts metadata and the packed label from raw cart bytes.
+    static void scanData(const uint8_t* data, size_t size, Real8PngCart::ColorMapFn mapColor, LibraryScan& out);
+    static void packLabel(const uint8_t (*label)[128], uint8_t* packed);
+    static void unpackLabel(const uint8_t* packed, uint8_t (*labelOut)[128]);
+
+    // UI thread: commits a scan result to the index and label file.
+    void store(IReal8Host* host, const LibraryScan& scan);
+
+    bool readLabel(IReal8Host* host, const LibraryEntry& e, uint8_t (*labelOut)[128]) const;
+
+private:
+    int32_t allocSlot();
+    void releaseSlot(LibraryEntry& e);
+
+    std::map<std::string, LibraryEntry> entries;
+    std::vector<int32_t> freeSlots;
+    int32_t slotCount = 0;
+    bool loaded = false;
+    bool dirty = false;
+};
+
+// Byte-budgeted LRU of packed 4bpp labels, keyed by cart path or URL.
+// Misses are cached too (no label), so a cart without one is not decoded
+// again every time the cursor passes over it.
+class Real8LabelCache {
+public:
+    void setBudget(size_t bytes);
+    bool contains(const std::string& key) const { return index.count(key) != 0; }
+    // Unpacks into labelOut (if it has a label) and marks the entry recent.
+    bool get(const std::string& key, uint8_t (*labelOut)[128], bool& hasLabel);
+    void put(const std::string& key, const uint8_t* packed);
+    void clear();
+    size_t bytes() const { return used; }
+
+private:
+    struct Node {
+        std::string key;
+        std::vector<uint8_t> packed; // empty = known to have no label
+    };
+    static size_t cost(const Node& n) { return n.packed.size() + n.key.size() + 64; }
+    void trim();
+
+    std::list<Node> lru; // front = most recent
+    std::unordered_map<std::string, std::list<Node>::iterator> index;
+    size_t used = 0;
+    size_t budget = 0;
+};
+
+// Bounded multi-producer/multi-consumer queue (Vyukov). Each cell carries a
+// sequence number so push/pop only need one CAS on the shared index.
+template <typename T, size_t N>
+class LockFreeQueue {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+public:
+    LockFreeQueue() {
+        for (size_t i = 0; i < N; i++) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(T v) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells[pos & (N - 1)];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = v;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T& out) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells[pos & (N - 1)];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = c.value;
+                    c.seq.store(pos + N, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+    Cell cells[N];
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+// Background scanning for the shell browser.
+//
+// Workers stat carts, and decode the ones whose size/mtime no longer match
+// the index. Preview requests (the selected entry) are served before the
+// background sweep. Both kinds are cancelled by bumping a generation counter;
+// a worker drops stale jobs before touching the file. Results come back to
+// the UI thread through poll().
+class Real8LibraryScanner {
+public:
+    Real8LibraryScanner(IReal8Host* host, Real8PngCart::ColorMapFn mapColor, int threads);
+    ~Real8LibraryScanner();
+
+    bool submit(const LibraryEntry& e, bool preview);
+    void cancelPreviews();
+    void cancelAll();
+
+    std::unique_ptr<LibraryScan> poll();
+    bool idle() const { return inFlight.load(std::memory_order_acquire) == 0; }
+
+private:
+    struct Job {
+        std::string path;
+        uint64_t size;
+        uint64_t mtime;
+        bool scanned;
+        bool preview;
+        uint32_t generation;
+    };
+
+    bool stale(const Job& job) const;
+    void workerLoop();
+
+    IReal8Host* host;
+    Real8PngCart::ColorMapFn mapColor;
+
+    LockFreeQueue<Job*, 64> previewJobs;
+    LockFreeQueue<Job*, 4096> scanJobs;
+    LockFreeQueue<LibraryScan*, 64> results;
+
+    std::atomic<uint32_t> previewGeneration{0};
+    std::atomic<uint32_t> scanGeneration{0};
+    std::atomic<int> queued{0};
+    std::atomic<int> inFlight{0};
+    std::atomic<bool> stopping{false};
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::vector<std::thread> workers;
+};
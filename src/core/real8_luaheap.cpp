@@ -0,0 +1,203 @@
+#include "real8_luaheap.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const size_t GRANULE = 8;
+const size_t CHUNK_HEADER = 16; // Chunk rounded up so slots stay 8-aligned
+
+inline size_t classBytes(size_t size) { return (size + GRANULE - 1) & ~(GRANULE - 1); }
+inline int classOf(size_t size) { return (int)(classBytes(size) / GRANULE) - 1; }
+
+} // namespace
+
+Real8LuaHeap::Real8LuaHeap()
+    : chunks(nullptr), adoptedCount(0), bump(nullptr), bumpEnd(nullptr)
+{
+    memset(freeList, 0, sizeof(freeList));
+    memset(adopted, 0, sizeof(adopted));
+    memset(&st, 0, sizeof(st));
+}
+
+Real8LuaHeap::~Real8LuaHeap()
+{
+    release();
+}
+
+void Real8LuaHeap::release()
+{
+    while (chunks) {
+        Chunk* next = chunks->next;
+        free(chunks);
+        chunks = next;
+    }
+    for (int i = 0; i < adoptedCount; i++) free(adopted[i]);
+    adoptedCount = 0;
+    memset(freeList, 0, sizeof(freeList));
+    bump = bumpEnd = nullptr;
+    memset(&st, 0, sizeof(st));
+}
+
+Real8LuaHeap::Stats Real8LuaHeap::stats() const
+{
+    Stats s = st;
+    s.freeBytes += (size_t)(bumpEnd - bump); // untouched end of the current chunk
+    return s;
+}
+
+void Real8LuaHeap::notePeak()
+{
+    size_t total = st.arenaBytes + st.largeBytes;
+    if (total > st.peakBytes) st.peakBytes = total;
+}
+
+// Parks [p, p + n) on the free lists as slots of at most MAX_SMALL bytes.
+void Real8LuaHeap::donate(uint8_t* p, size_t n)
+{
+    n &= ~(GRANULE - 1);
+    while (n >= GRANULE) {
+        size_t piece = n < MAX_SMALL ? n : MAX_SMALL;
+        Slot* s = (Slot*)p;
+        s->next = freeList[classOf(piece)];
+        freeList[classOf(piece)] = s;
+        st.freeBytes += piece;
+        p += piece;
+        n -= piece;
+    }
+}
+
+bool Real8LuaHeap::grow()
+{
+    static_assert(sizeof(Chunk) <= CHUNK_HEADER, "chunk header overlaps the first slot");
+    Chunk* c = (Chunk*)malloc(CHUNK_SIZE);
+    if (!c) return false;
+    c->next = chunks;
+    chunks = c;
+    // Whatever the old chunk has left is still good for smaller classes
+    donate(bump, (size_t)(bumpEnd - bump));
+    bump = (uint8_t*)c + CHUNK_HEADER;
+    bumpEnd = (uint8_t*)c + CHUNK_SIZE;
+    st.arenaBytes += CHUNK_SIZE;
+    st.chunkCount++;
+    notePeak();
+    return true;
+}
+
+void* Real8LuaHeap::allocSmall(size_t size)
+{
+    const int cls = classOf(size);
+    const size_t bytes = classBytes(size);
+    void* p;
+    if (freeList[cls]) {
+        Slot* s = freeList[cls];
+        freeList[cls] = s->next;
+        st.freeBytes -= bytes;
+        p = s;
+    } else {
+        if ((size_t)(bumpEnd - bump) < bytes && !grow()) return nullptr;
+        p = bump;
+        bump += bytes;
+    }
+    st.usedBytes += bytes;
+    return p;
+}
+
+void Real8LuaHeap::freeSmall(void* p, size_t size)
+{
+    const int cls = classOf(size);
+    Slot* s = (Slot*)p;
+    s->next = freeList[cls];
+    freeList[cls] = s;
+    st.usedBytes -= classBytes(size);
+    st.freeBytes += classBytes(size);
+}
+
+// Shrinking a large block into the pool must not fail (Lua asserts on it).
+// With no chunk to be had, the block itself joins the arena: the data stays
+// at its head and the rest is donated to the free lists.
+void* Real8LuaHeap::adopt(void* block, size_t osize, size_t nsize)
+{
+    if (adoptedCount >= ADOPT_MAX) return nullptr;
+    adopted[adoptedCount++] = block;
+    st.largeBytes -= osize;
+    st.largeCount--;
+    st.arenaBytes += osize;
+    st.usedBytes += classBytes(nsize);
+    donate((uint8_t*)block + classBytes(nsize), osize - classBytes(nsize));
+    return block;
+}
+
+void* Real8LuaHeap::alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    Real8LuaHeap* h = (Real8LuaHeap*)ud;
+
+    if (nsize == 0) {
+        if (!ptr) return nullptr;
+        if (osize <= MAX_SMALL) {
+            h->freeSmall(ptr, osize);
+        } else {
+            free(ptr);
+            h->st.largeBytes -= osize;
+            h->st.largeCount--;
+        }
+        return nullptr;
+    }
+
+    if (!ptr) { // osize is only a type tag here
+        if (nsize <= MAX_SMALL) return h->allocSmall(nsize);
+        void* p = malloc(nsize);
+        if (!p) return nullptr;
+        h->st.largeBytes += nsize;
+        h->st.largeCount++;
+        h->notePeak();
+        return p;
+    }
+
+    const bool wasSmall = osize <= MAX_SMALL;
+    const bool isSmall = nsize <= MAX_SMALL;
+
+    if (wasSmall && isSmall) {
+        if (classOf(osize) == classOf(nsize)) return ptr;
+        void* p = h->allocSmall(nsize);
+        if (!p) {
+            if (nsize > osize) return nullptr;
+            // Out of chunks: shrink in place and free the tail
+            const size_t keep = classBytes(nsize);
+            h->st.usedBytes -= classBytes(osize) - keep;
+            h->donate((uint8_t*)ptr + keep, classBytes(osize) - keep);
+            return ptr;
+        }
+        memcpy(p, ptr, osize < nsize ? osize : nsize);
+        h->freeSmall(ptr, osize);
+        return p;
+    }
+
+    if (!wasSmall && !isSmall) {
+        void* p = realloc(ptr, nsize);
+        if (!p) return nullptr;
+        h->st.largeBytes = h->st.largeBytes - osize + nsize;
+        h->notePeak();
+        return p;
+    }
+
+    if (wasSmall) { // growing out of the pool
+        void* p = malloc(nsize);
+        if (!p) return nullptr;
+        memcpy(p, ptr, osize);
+        h->freeSmall(ptr, osize);
+        h->st.largeBytes += nsize;
+        h->st.largeCount++;
+        h->notePeak();
+        return p;
+    }
+
+    // Shrinking into the pool
+    void* p = h->allocSmall(nsize);
+    if (!p) return h->adopt(ptr, osize, nsize);
+    memcpy(p, ptr, nsize);
+    free(ptr);
+    h->st.largeBytes -= osize;
+    h->st.largeCount--;
+    return p;
+}
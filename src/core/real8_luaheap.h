@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Pool the Lua state on the consoles; desktop hosts keep plain realloc.
+#ifndef REAL8_LUA_POOL
+#if defined(__GBA__) || defined(__3DS__)
+#define REAL8_LUA_POOL 1
+#else
+#define REAL8_LUA_POOL 0
+#endif
+#endif
+
+// Allocator for the cart's Lua state on the memory-constrained targets.
+//
+// Blocks up to MAX_SMALL bytes (tables, closures, upvalues, short strings,
+// small arrays) are served from size classes 8 bytes apart, carved out of
+// CHUNK_SIZE arena chunks and recycled through per-class free lists, so
+// the churn of a running cart never reaches the system heap. Larger blocks
+// go straight to malloc. The arena belongs to one cart: release() hands
+// every chunk back at once after lua_close, so the next cart starts from
+// the same few big holes instead of whatever the last one left behind.
+//
+// Slots carry no header: a block's class comes from the old size given to
+// every free/realloc, so whoever frees must pass the size it allocated
+// (luaM_freemem with the real size for variable-length blocks, never
+// luaM_free on a struct with a trailing array).
+class Real8LuaHeap {
+public:
+    static const size_t MAX_SMALL = 256;
+    static const int CLASS_COUNT = (int)(MAX_SMALL / 8);
+#if defined(__GBA__)
+    static const size_t CHUNK_SIZE = 4 * 1024;
+#else
+    static const size_t CHUNK_SIZE = 32 * 1024;
+#endif
+
+    struct Stats {
+        size_t arenaBytes;   // reserved in chunks
+        size_t usedBytes;    // live small blocks, rounded to their class
+        size_t freeBytes;    // parked on the free lists
+        size_t largeBytes;   // live blocks above MAX_SMALL
+        uint32_t largeCount;
+        uint32_t chunkCount;
+        size_t peakBytes;    // high-water mark of arena + large
+        // Share of the arena not holding live data, in percent.
+        int fragmentationPct() const {
+            return arenaBytes ? (int)(((arenaBytes - usedBytes) * 100) / arenaBytes) : 0;
+        }
+    };
+
+    Real8LuaHeap();
+    ~Real8LuaHeap();
+    Real8LuaHeap(const Real8LuaHeap&) = delete;
+    Real8LuaHeap& operator=(const Real8LuaHeap&) = delete;
+
+    // lua_Alloc; ud is the Real8LuaHeap.
+    static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    // Frees every chunk. Only valid once the state using it is closed.
+    void release();
+    Stats stats() const;
+
+private:
+    struct Chunk { Chunk* next; };
+    struct Slot { Slot* next; };
+
+    void* allocSmall(size_t size);
+    void freeSmall(void* p, size_t size);
+    bool grow();
+    void donate(uint8_t* p, size_t n);
+    void* adopt(void* block, size_t osize, size_t nsize);
+    void notePeak();
+
+    static const int ADOPT_MAX = 16;
+
+    Slot* freeList[CLASS_COUNT];
+    Chunk* chunks;
+    void* adopted[ADOPT_MAX];
+    int adoptedCount;
+    uint8_t* bump;
+    uint8_t* bumpEnd;
+    Stats st;
+};
@@ -0,0 +1,567 @@
+#include "real8_png.h"
+#include <lodePNG.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+// --------------------------------------------------------------------------
+// CHUNK HELPERS
+// --------------------------------------------------------------------------
+
+namespace {
+
+inline uint32_t readBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+struct Crc32Table {
+    uint32_t t[256];
+    Crc32Table() {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            t[n] = c;
+        }
+    }
+};
+
+uint32_t crc32(const uint8_t* p, size_t n) {
+    static const Crc32Table table;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++) c = table.t[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+struct Span {
+    const uint8_t* data;
+    size_t len;
+};
+
+// --------------------------------------------------------------------------
+// HUFFMAN TABLES
+// --------------------------------------------------------------------------
+// Codes up to FAST_BITS long resolve with one lookup; longer ones walk the
+// canonical per-length limits.
+
+const int FAST_BITS = 9;
+const int FAST_MASK = (1 << FAST_BITS) - 1;
+
+struct Huffman {
+    uint16_t fast[1 << FAST_BITS];
+    uint16_t firstcode[16];
+    int maxcode[17];
+    uint16_t firstsymbol[16];
+    uint8_t size[288];
+    uint16_t value[288];
+};
+
+inline int bitReverse16(int n) {
+    n = ((n & 0xAAAA) >> 1) | ((n & 0x5555) << 1);
+    n = ((n & 0xCCCC) >> 2) | ((n & 0x3333) << 2);
+    n = ((n & 0xF0F0) >> 4) | ((n & 0x0F0F) << 4);
+    n = ((n & 0xFF00) >> 8) | ((n & 0x00FF) << 8);
+    return n;
+}
+
+bool buildHuffman(Huffman& z, const uint8_t* lengths, int num) {
+    int counts[17] = {0};
+    int nextCode[16];
+    memset(z.fast, 0, sizeof(z.fast));
+    // An incomplete code leaves slots unassigned; size 0 makes decode() reject them.
+    memset(z.size, 0, sizeof(z.size));
+    memset(z.value, 0, sizeof(z.value));
+    for (int i = 0; i < num; i++) counts[lengths[i]]++;
+    counts[0] = 0;
+
+    int code = 0, k = 0;
+    for (int i = 1; i < 16; i++) {
+        nextCode[i] = code;
+        z.firstcode[i] = (uint16_t)code;
+        z.firstsymbol[i] = (uint16_t)k;
+        code += counts[i];
+        if (counts[i] && code - 1 >= (1 << i)) return false; // over-subscribed
+        z.maxcode[i] = code << (16 - i);
+        code <<= 1;
+        k += counts[i];
+    }
+    z.maxcode[16] = 0x10000;
+
+    for (int i = 0; i < num; i++) {
+        int s = lengths[i];
+        if (!s) continue;
+        int c = nextCode[s] - z.firstcode[s] + z.firstsymbol[s];
+        z.size[c] = (uint8_t)s;
+        z.value[c] = (uint16_t)i;
+        if (s <= FAST_BITS) {
+            int j = bitReverse16(nextCode[s]) >> (16 - s);
+            while (j < (1 << FAST_BITS)) {
+                z.fast[j] = (uint16_t)((s << 9) | i);
+                j += (1 << s);
+            }
+        }
+        nextCode[s]++;
+    }
+    return true;
+}
+
+const uint16_t LEN_BASE[31] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258, 0, 0 };
+const uint8_t LEN_EXTRA[31] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0, 0, 0 };
+const uint16_t DIST_BASE[32] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                 8193, 12289, 16385, 24577, 0, 0 };
+const uint8_t DIST_EXTRA[32] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 0, 0 };
+
+// --------------------------------------------------------------------------
+// SCANLINE SINK
+// --------------------------------------------------------------------------
+// Reassembles filtered rows from the inflated byte stream, unfilters against
+// the previous row and scatters each pixel into the cart/label outputs.
+
+struct RowSink {
+    int w = 0, h = 0, bpp = 4;
+    size_t stride = 0;
+    std::vector<uint8_t> cur, prev;
+    size_t fill = 0;
+    int filter = -1;
+    int y = 0;
+    int rowsNeeded = 0;
+    bool failed = false;
+
+    uint8_t* cart = nullptr;
+    size_t cartCap = 0;
+    uint8_t (*label)[Real8PngCart::LABEL_SIZE] = nullptr;
+    Real8PngCart::ColorMapFn mapColor = nullptr;
+
+    bool done() const { return y >= rowsNeeded; }
+
+    void unfilter() {
+        uint8_t* c = cur.data();
+        const uint8_t* p = prev.data();
+        const size_t n = stride;
+        const int b = bpp;
+        switch (filter) {
+            case 0: break;
+            case 1:
+                for (size_t i = b; i < n; i++) c[i] = (uint8_t)(c[i] + c[i - b]);
+                break;
+            case 2:
+                for (size_t i = 0; i < n; i++) c[i] = (uint8_t)(c[i] + p[i]);
+                break;
+            case 3:
+                for (int i = 0; i < b; i++) c[i] = (uint8_t)(c[i] + (p[i] >> 1));
+                for (size_t i = b; i < n; i++) c[i] = (uint8_t)(c[i] + ((c[i - b] + p[i]) >> 1));
+                break;
+            case 4:
+                for (int i = 0; i < b; i++) c[i] = (uint8_t)(c[i] + p[i]);
+                for (size_t i = b; i < n; i++) {
+                    int a = c[i - b], up = p[i], ul = p[i - b];
+                    int pa = abs(up - ul), pb = abs(a - ul), pc = abs(a + up - ul - ul);
+                    int pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? up : ul);
+                    c[i] = (uint8_t)(c[i] + pred);
+                }
+                break;
+            default:
+                failed = true;
+                break;
+        }
+    }
+
+    void emitRow() {
+        const uint8_t* px = cur.data();
+        const size_t rowStart = (size_t)y * (size_t)w;
+        if (cart && rowStart < cartCap) {
+            size_t count = cartCap - rowStart;
+            if (count > (size_t)w) count = (size_t)w;
+            uint8_t* out = cart + rowStart;
+            if (bpp == 4) {
+                for (size_t x = 0; x < count; x++, px += 4)
+                    out[x] = (uint8_t)(((px[3] & 3) << 6) | ((px[0] & 3) << 4) | ((px[1] & 3) << 2) | (px[2] & 3));
+            } else {
+                for (size_t x = 0; x < count; x++, px += 3)
+                    out[x] = (uint8_t)(0xC0 | ((px[0] & 3) << 4) | ((px[1] & 3) << 2) | (px[2] & 3));
+            }
+        }
+
+        const int ly = y - Real8PngCart::LABEL_Y;
+        if (label && ly >= 0 && ly < Real8PngCart::LABEL_SIZE) {
+            int x1 = Real8PngCart::LABEL_X + Real8PngCart::LABEL_SIZE;
+            if (x1 > w) x1 = w;
+            uint8_t* out = label[ly];
+            for (int x = Real8PngCart::LABEL_X; x < x1; x++) {
+                const uint8_t* q = cur.data() + (size_t)x * bpp;
+                const uint8_t a = (bpp == 4) ? q[3] : 255;
+                out[x - Real8PngCart::LABEL_X] = (a < 128) ? 0 : mapColor(q[0], q[1], q[2]);
+            }
+        }
+    }
+
+    void feed(const uint8_t* p, size_t n) {
+        while (n > 0 && !done() && !failed) {
+            if (filter < 0) {
+                filter = *p++;
+                n--;
+                continue;
+            }
+            size_t take = stride - fill;
+            if (take > n) take = n;
+            memcpy(cur.data() + fill, p, take);
+            fill += take;
+            p += take;
+            n -= take;
+            if (fill == stride) {
+                unfilter();
+                if (failed) return;
+                emitRow();
+                cur.swap(prev);
+                fill = 0;
+                filter = -1;
+                y++;
+            }
+        }
+    }
+};
+
+// --------------------------------------------------------------------------
+// INFLATE
+// --------------------------------------------------------------------------
+// Output goes to a 32KB ring (the maximum deflate distance) and is drained
+// into the sink before it can be overwritten.
+
+const uint32_t WINDOW_SIZE = 32768;
+const uint32_t WINDOW_MASK = WINDOW_SIZE - 1;
+const uint32_t FLUSH_AT = 16384;
+
+struct Inflater {
+    const Span* spans = nullptr;
+    int spanCount = 0;
+    int span = 0;
+    size_t spanPos = 0;
+    uint64_t bits = 0;
+    int nbits = 0;
+    int padded = 0;
+
+    uint8_t window[WINDOW_SIZE];
+    uint32_t total = 0;
+    uint32_t flushed = 0;
+    uint32_t adlerA = 1, adlerB = 0;
+
+    Huffman lit, dist;
+    RowSink* sink = nullptr;
+
+    void refill() {
+        while (nbits <= 56) {
+            uint32_t b = 0;
+            while (span < spanCount && spanPos >= spans[span].len) { span++; spanPos = 0; }
+            if (span < spanCount) b = spans[span].data[spanPos++];
+            else padded++;
+            bits |= (uint64_t)b << nbits;
+            nbits += 8;
+        }
+    }
+
+    // Only bail out mid-stream when the tail rows are not wanted; a full
+    // decode runs to the end so the Adler-32 trailer gets checked.
+    bool stopEarly() const { return sink->failed || (sink->done() && sink->rowsNeeded < sink->h); }
+
+    // True once decoding has eaten into the zero padding past the stream.
+    bool overrun() const { return padded * 8 > nbits; }
+
+    uint32_t getBits(int n) {
+        if (nbits < n) refill();
+        uint32_t v = (uint32_t)(bits & ((1ull << n) - 1));
+        bits >>= n;
+        nbits -= n;
+        return v;
+    }
+
+    int decode(const Huffman& z) {
+        if (nbits < 16) refill();
+        int b = z.fast[bits & FAST_MASK];
+        if (b) {
+            int s = b >> 9;
+            bits >>= s;
+            nbits -= s;
+            return b & 511;
+        }
+        int k = bitReverse16((int)(bits & 0xFFFF));
+        int s = FAST_BITS + 1;
+        while (k >= z.maxcode[s]) s++;
+        if (s >= 16) return -1;
+        int c = (k >> (16 - s)) - z.firstcode[s] + z.firstsymbol[s];
+        if (c < 0 || c >= 288 || z.size[c] != s) return -1;
+        bits >>= s;
+        nbits -= s;
+        return z.value[c];
+    }
+
+    void drain(const uint8_t* p, size_t n) {
+        // Adler-32 in NMAX-sized runs so the sums never overflow.
+        while (n > 0) {
+            size_t run = n < 5552 ? n : 5552;
+            for (size_t i = 0; i < run; i++) {
+                adlerA += p[i];
+                adlerB += adlerA;
+            }
+            adlerA %= 65521;
+            adlerB %= 65521;
+            sink->feed(p, run);
+            p += run;
+            n -= run;
+        }
+    }
+
+    void flush() {
+        uint32_t pending = total - flushed;
+        uint32_t start = flushed & WINDOW_MASK;
+        uint32_t first = WINDOW_SIZE - start;
+        if (first > pending) first = pending;
+        drain(window + start, first);
+        if (pending > first) drain(window, pending - first);
+        flushed = total;
+    }
+
+    bool stored() {
+        getBits(nbits & 7);
+        uint32_t len = getBits(16);
+        uint32_t nlen = getBits(16);
+        if ((len ^ 0xFFFF) != nlen) return false;
+        while (len--) {
+            window[total++ & WINDOW_MASK] = (uint8_t)getBits(8);
+            if (total - flushed >= FLUSH_AT) {
+                flush();
+                if (stopEarly()) return true;
+            }
+        }
+        return !overrun();
+    }
+
+    bool dynamicTables() {
+        static const uint8_t ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+        Huffman codeLen;
+        uint8_t lengths[286 + 32];
+        uint8_t clens[19] = {0};
+
+        int hlit = getBits(5) + 257;
+        int hdist = getBits(5) + 1;
+        int hclen = getBits(4) + 4;
+        for (int i = 0; i < hclen; i++) clens[ORDER[i]] = (uint8_t)getBits(3);
+        if (!buildHuffman(codeLen, clens, 19)) return false;
+
+        int n = 0, ntot = hlit + hdist;
+        while (n < ntot) {
+            int c = decode(codeLen);
+            if (c < 0 || c >= 19) return false;
+            if (c < 16) { lengths[n++] = (uint8_t)c; continue; }
+            uint8_t fillv = 0;
+            int rep;
+            if (c == 16) {
+                if (n == 0) return false;
+                rep = getBits(2) + 3;
+                fillv = lengths[n - 1];
+            } else if (c == 17) {
+                rep = getBits(3) + 3;
+            } else {
+                rep = getBits(7) + 11;
+            }
+            if (ntot - n < rep) return false;
+            memset(lengths + n, fillv, rep);
+            n += rep;
+        }
+        if (overrun()) return false;
+        return buildHuffman(lit, lengths, hlit) && buildHuffman(dist, lengths + hlit, hdist);
+    }
+
+    void fixedTables() {
+        uint8_t lengths[288 + 32];
+        int i = 0;
+        for (; i <= 143; i++) lengths[i] = 8;
+        for (; i <= 255; i++) lengths[i] = 9;
+        for (; i <= 279; i++) lengths[i] = 7;
+        for (; i <= 287; i++) lengths[i] = 8;
+        for (i = 0; i < 32; i++) lengths[288 + i] = 5;
+        buildHuffman(lit, lengths, 288);
+        buildHuffman(dist, lengths + 288, 32);
+    }
+
+    bool compressed() {
+        for (;;) {
+            int sym = decode(lit);
+            if (sym < 256) {
+                if (sym < 0) return false;
+                window[total++ & WINDOW_MASK] = (uint8_t)sym;
+            } else if (sym == 256) {
+                return !overrun();
+            } else {
+                sym -= 257;
+                if (sym >= 29) return false;
+                int len = LEN_BASE[sym] + (LEN_EXTRA[sym] ? (int)getBits(LEN_EXTRA[sym]) : 0);
+                int d = decode(dist);
+                if (d < 0 || d >= 30) return false;
+                uint32_t back = DIST_BASE[d] + (DIST_EXTRA[d] ? getBits(DIST_EXTRA[d]) : 0);
+                if (back > total) return false;
+                uint32_t src = total - back;
+                while (len--) window[total++ & WINDOW_MASK] = window[src++ & WINDOW_MASK];
+            }
+            if (total - flushed >= FLUSH_AT) {
+                if (overrun()) return false;
+                flush();
+                if (stopEarly()) return true;
+            }
+        }
+    }
+
+    // Returns true when the sink got every row it asked for.
+    bool run() {
+        uint32_t cmf = getBits(8), flg = getBits(8);
+        if ((cmf & 15) != 8 || (cmf >> 4) > 7 || (flg & 32) || ((cmf << 8) | flg) % 31 != 0) return false;
+
+        bool final = false;
+        while (!final) {
+            final = getBits(1) != 0;
+            uint32_t type = getBits(2);
+            bool ok;
+            if (type == 0) ok = stored();
+            else if (type == 1) { fixedTables(); ok = compressed(); }
+            else if (type == 2) ok = dynamicTables() && compressed();
+            else ok = false;
+            if (!ok || sink->failed) return false;
+            if (stopEarly()) return true;
+        }
+
+        flush();
+        if (sink->failed || !sink->done()) return false;
+
+        // Whole stream consumed: verify the trailer like lodepng would.
+        getBits(nbits & 7);
+        uint32_t adler = 0;
+        for (int i = 0; i < 4; i++) adler = (adler << 8) | getBits(8);
+        return !overrun() && adler == ((adlerB << 16) | adlerA);
+    }
+};
+
+// Fast path. Returns 1 on success, 0 on a decode error, -1 when the image
+// layout is not one the streaming path handles.
+int decodeStreaming(const uint8_t* png, size_t size, RowSink& sink) {
+    static const uint8_t SIG[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    if (size < 8 + 25 || memcmp(png, SIG, 8) != 0) return 0;
+
+    std::vector<Span> idat;
+    bool haveHeader = false;
+    int colorType = 0;
+    size_t pos = 8;
+    while (pos + 12 <= size) {
+        uint32_t len = readBE32(png + pos);
+        if (len > size - pos - 12) return 0;
+        const uint8_t* type = png + pos + 4;
+        const uint8_t* data = png + pos + 8;
+        const bool critical = (type[0] & 0x20) == 0;
+
+        if (!haveHeader && memcmp(type, "IHDR", 4) != 0) return 0;
+        if (crc32(type, len + 4) != readBE32(data + len)) return 0;
+
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (len != 13) return 0;
+            sink.w = (int)readBE32(data);
+            sink.h = (int)readBE32(data + 4);
+            colorType = data[9];
+            if (sink.w <= 0 || sink.h <= 0) return 0;
+            if (sink.w > 0x4000 || sink.h > 0x4000) return -1;
+            if (data[8] != 8 || (colorType != 6 && colorType != 2)) return -1;
+            if (data[10] != 0 || data[11] != 0) return 0;
+            if (data[12] != 0) return -1; // Adam7
+            haveHeader = true;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            idat.push_back({ data, len });
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            return -1; // colour-key transparency changes the decoded alpha
+        } else if (critical && memcmp(type, "PLTE", 4) != 0) {
+            return -1;
+        }
+        pos += 12 + (size_t)len;
+    }
+    if (!haveHeader || idat.empty()) return 0;
+
+    sink.bpp = (colorType == 6) ? 4 : 3;
+    sink.stride = (size_t)sink.w * sink.bpp;
+    sink.cur.assign(sink.stride, 0);
+    sink.prev.assign(sink.stride, 0);
+
+    int cartRows = 0;
+    if (sink.cart) cartRows = (int)((sink.cartCap + sink.w - 1) / sink.w);
+    int labelRows = sink.label ? Real8PngCart::LABEL_Y + Real8PngCart::LABEL_SIZE : 0;
+    sink.rowsNeeded = cartRows > labelRows ? cartRows : labelRows;
+    if (sink.rowsNeeded > sink.h) sink.rowsNeeded = sink.h;
+
+    std::unique_ptr<Inflater> inf(new (std::nothrow) Inflater());
+    if (!inf) return -1;
+    inf->spans = idat.data();
+    inf->spanCount = (int)idat.size();
+    inf->sink = &sink;
+    return inf->run() ? 1 : 0;
+}
+
+} // namespace
+
+// --------------------------------------------------------------------------
+// PUBLIC ENTRY
+// --------------------------------------------------------------------------
+
+bool Real8PngCart::Decode(const uint8_t* png, size_t size,
+                          uint8_t* cart, size_t cartCap, size_t* cartLen,
+                          uint8_t (*label)[LABEL_SIZE], ColorMapFn mapColor) {
+    if (cart) memset(cart, 0, cartCap);
+    if (label) memset(label, 0, (size_t)LABEL_SIZE * LABEL_SIZE);
+    if (cartLen) *cartLen = 0;
+    if (!mapColor) label = nullptr;
+
+    RowSink sink;
+    sink.cart = cart;
+    sink.cartCap = cartCap;
+    sink.label = label;
+    sink.mapColor = mapColor;
+
+    int res = decodeStreaming(png, size, sink);
+    if (res > 0) {
+        if (cartLen) {
+            size_t pixels = (size_t)sink.w * (size_t)sink.h;
+            *cartLen = pixels < cartCap ? pixels : cartCap;
+        }
+        return true;
+    }
+    if (res == 0) return false;
+
+    // Uncommon layout: full RGBA decode.
+    unsigned w, h;
+    unsigned char* image = nullptr;
+    unsigned error = lodepng_decode32(&image, &w, &h, png, size);
+    if (error || !image) { if (image) free(image); return false; }
+
+    const size_t pixels = (size_t)w * h;
+    if (cart) {
+        size_t n = pixels < cartCap ? pixels : cartCap;
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* q = image + i * 4;
+            cart[i] = (uint8_t)(((q[3] & 3) << 6) | ((q[0] & 3) << 4) | ((q[1] & 3) << 2) | (q[2] & 3));
+        }
+        if (cartLen) *cartLen = n;
+    }
+    if (label) {
+        for (int y = 0; y < LABEL_SIZE; ++y) {
+            for (int x = 0; x < LABEL_SIZE; ++x) {
+                unsigned sx = LABEL_X + x, sy = LABEL_Y + y;
+                if (sx >= w || sy >= h) continue;
+                const uint8_t* q = image + ((size_t)sy * w + sx) * 4;
+                label[y][x] = (q[3] < 128) ? 0 : mapColor(q[0], q[1], q[2]);
+            }
+        }
+    }
+    free(image);
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Streaming decoder for PICO-8 .p8.png carts.
+//
+// Inflates the IDAT stream through a 32KB window and unfilters one scanline
+// at a time, so the cart bytes (low 2 bits of A/R/G/B per pixel) and the
+// 128x128 label are written straight to their destinations without ever
+// materialising the full RGBA image. Anything outside the common 8-bit
+// RGB/RGBA non-interlaced layout is handed to lodepng instead.
+class Real8PngCart {
+public:
+    typedef uint8_t (*ColorMapFn)(uint8_t r, uint8_t g, uint8_t b);
+
+    static const int LABEL_X = 16;
+    static const int LABEL_Y = 25;
+    static const int LABEL_SIZE = 128;
+
+    // cart/cartCap: receives up to cartCap steganographic bytes; the rest is
+    //   zero-filled and *cartLen reports how many the image actually held.
+    // label/mapColor: optional 128x128 palette-index label; pixels with
+    //   alpha < 128 map to 0. Pass nullptr to skip either output, rows past
+    //   the last one needed are never inflated.
+    static bool Decode(const uint8_t* png, size_t size,
+                       uint8_t* cart, size_t cartCap, size_t* cartLen,
+                       uint8_t (*label)[LABEL_SIZE], ColorMapFn mapColor);
+};
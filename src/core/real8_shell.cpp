@@ -5,8 +5,9 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
-#include <lodePNG.h>
 #include "real8_cart.h"
+#include "real8_cartcache.h"
+#include "real8_png.h"
 #include "real8_fonts.h"
 
 // --------------------------------------------------------------------------
@@ -236,6 +237,9 @@ static uint8_t find_closest_p8_color(uint8_t r, uint8_t g, uint8_t b)
 Real8Shell::Real8Shell(IReal8Host* h, Real8VM* v) : host(h), vm(v)
 {
     isSwitchPlatform = (strcmp(host->getPlatform(), "Switch") == 0);
+    unsigned cores = std::thread::hardware_concurrency();
+    previewCache.setBudget(strcmp(host->getPlatform(), "3DS") == 0 ? PREVIEW_CACHE_BYTES_3DS : PREVIEW_CACHE_BYTES);
+    libraryScanner.reset(new Real8LibraryScanner(host, find_closest_p8_color, cores > 1 ? (int)std::min(cores - 1, 3u) : 1));
     initStars();
     sysState = STATE_BROWSER;
     
@@ -249,6 +253,7 @@ Real8Shell::~Real8Shell()
     if (repoDownload.worker.joinable()) repoDownload.worker.join();
     if (previewDownload.worker.joinable()) previewDownload.worker.join();
     if (gameDownload.worker.joinable()) gameDownload.worker.join();
+    libraryScanner.reset();
     // Host and VM are owned by Main/Libretro, not Shell
 }
 
@@ -258,6 +263,7 @@ void Real8Shell::update()
     host->pollInput();
     updatePointerState();
     updateAsyncDownloads();
+    updateLibraryScan();
     ShellState prevState = lastState;
 
     // Tell the VM whether we are rendering shell/UI (menus) vs gameplay.
@@ -407,8 +413,8 @@ void Real8Shell::update()
             if (targetGame.path != lastPreviewPath) {
                 if (is3ds) {
                     bool hasCachedPreview = false;
-                    auto cached = previewCache.find(targetGame.path);
-                    if (cached != previewCache.end() && !cached->second.empty()) hasCachedPreview = true;
+                    if (previewCache.contains(targetGame.path)) hasCachedPreview = true;
+                    if (!targetGame.isRemote && library.hasLabel(targetGame.path)) hasCachedPreview = true;
                     if (!hasCachedPreview) {
                         clearPreview();
                         renderFileList(false);
@@ -682,10 +688,10 @@ void Real8Shell::updateAsyncDownloads()
         if (ok) {
             std::vector<uint8_t> data = host->loadFile(previewDownload.path.c_str());
             if (!data.empty()) {
-                previewCache[previewDownload.url] = data;
+                cachePreviewLabel(previewDownload.url, data.data(), data.size());
                 if (fileSelection >= 0 && fileSelection < (int)gameList.size() &&
                     gameList[fileSelection].path == previewDownload.url) {
-                    loadPreview(data.data(), data.size());
+                    showCachedPreview(previewDownload.url);
                 }
             }
         }
@@ -721,15 +727,38 @@ bool Real8Shell::shouldShowPreviewForEntry(const GameEntry &e) const
 
 bool Real8Shell::loadPreviewForEntry(GameEntry &e, bool normalMenu, bool allowFetch, bool showFetchMsg)
 {
+    // Moving off an entry drops its queued label request.
+    if (e.path != previewLabelPath) {
+        libraryScanner->cancelPreviews();
+        previewLabelPath.clear();
+    }
+
     if (e.isFolder) {
         clearPreview();
         return false;
     }
 
-    auto cached = previewCache.find(e.path);
-    if (cached != previewCache.end() && !cached->second.empty()) {
-        loadPreview(cached->second.data(), cached->second.size());
-        return has_preview;
+    if (!e.isRemote) previewLabelPath = e.path;
+    if (showCachedPreview(e.path)) return has_preview;
+
+    // Local carts: show the indexed label, or let the scanner produce it.
+    // updateLibraryScan() fills the preview in once the result lands.
+    if (!e.isRemote) {
+        const LibraryEntry *info = library.find(e.path);
+        if (info && info->scanned) {
+            has_preview = library.readLabel(host, *info, preview_ram);
+            if (has_preview) {
+                uint8_t packed[Real8Library::LABEL_BYTES];
+                Real8Library::packLabel(preview_ram, packed);
+                previewCache.put(e.path, packed);
+            } else {
+                clearPreview();
+            }
+            return has_preview;
+        }
+        clearPreview();
+        if (info && allowFetch) libraryScanner->submit(*info, true);
+        return false;
     }
 
     if (!allowFetch) {
@@ -738,12 +767,8 @@ bool Real8Shell::loadPreviewForEntry(GameEntry &e, bool normalMenu, bool allowFe
     }
 
     std::vector<uint8_t> data;
-    if (!e.isRemote) {
-        data = host->loadFile(e.path.c_str());
-    } else if (normalMenu) {
-        if (!e.cacheData.empty()) {
-            data = e.cacheData;
-        } else if (isSwitchPlatform) {
+    if (normalMenu) {
+        if (isSwitchPlatform) {
             if (!previewDownload.active) {
                 startAsyncDownload(previewDownload, e.path, "/temp_preview.png");
             } else if (previewDownload.url != e.path) {
@@ -773,10 +798,8 @@ bool Real8Shell::loadPreviewForEntry(GameEntry &e, bool normalMenu, bool allowFe
     }
 
     if (!data.empty()) {
-        auto &preview = previewCache[e.path];
-        preview = std::move(data);
-        loadPreview(preview.data(), preview.size());
-        e.cacheData = preview;
+        cachePreviewLabel(e.path, data.data(), data.size());
+        showCachedPreview(e.path);
         return has_preview;
     }
 
@@ -884,7 +907,9 @@ void Real8Shell::updateBrowser()
         // Skip preview loading when snaps are hidden or the entry is a directory
         bool shouldLoadPreview = shouldShowPreviewForEntry(e);
         loadPreviewForEntry(e, normalMenu, shouldLoadPreview, true);
+        prefetchStep = 0;
     }
+    prefetchPreviews();
 
     // Interactions
     if (vm->btnp(0) && !gameList[fileSelection].isFolder) { // LEFT -> Options
@@ -1052,15 +1077,18 @@ void Real8Shell::updateLoading()
         }
     }
 
+    // Persist any labels scanned while browsing and free the cores for the cart.
+    libraryScanner->cancelAll();
+    library.save(host);
+
     // 3DS: Free network buffers BEFORE we parse/load the cart.
     if (strcmp(host->getPlatform(), "3DS") == 0) {
         host->setNetworkActive(false);
 
-        // Release menu/preview caches before parsing/compiling Lua (reduces peak heap).
+        // Release menu/preview state before parsing/compiling Lua (reduces peak heap).
+        // The label cache is budgeted, so it survives for the trip back.
         clearPreview();
-        previewCache.clear();
         pendingPreviewUrl.clear();
-        for (auto &e : gameList) e.cacheData.clear();
     }
 
     // Keep host menu items in sync by tracking the active game id
@@ -1075,8 +1103,8 @@ void Real8Shell::updateLoading()
     renderMessage("LOADING", targetGame.displayName, 12);
     vm->show_frame();
 
-    // 1. Load File Raw Data
-    std::vector<uint8_t> fileData = host->loadFile(targetGame.path.c_str());
+    // 1. Map the cart (zero-copy where the host supports it)
+    MappedFile fileData(host, targetGame.path.c_str());
 
     if (fileData.empty()) {
         errorTitle = "LOAD ERROR";
@@ -1102,16 +1130,18 @@ void Real8Shell::updateLoading()
         return;
     }
 
-    // Pass the dereferenced pointer (*gameData) to the loader
-    bool parseSuccess = Real8CartLoader::LoadFromBuffer(host, fileData, *gameData);
+    // Pass the dereferenced pointer (*gameData) to the loader; carts seen
+    // before come back from the cart cache with their compiled Lua.
+    bool parseSuccess = Real8CartCache::Load(host, fileData.data(), fileData.size(), *gameData);
 
     if (parseSuccess) {
 
         // Free raw cart buffer before Lua compile (peak-memory point).
-        std::vector<uint8_t>().swap(fileData);
+        fileData.release();
 
         // Pass the dereferenced pointer (*gameData) to the VM
         if (vm->loadGame(*gameData)) { 
+            Real8CartCache::Store(host, vm, *gameData);
             host->setNetworkActive(false);
             vm->resetInputState();
             sysState = STATE_RUNNING;
@@ -1270,6 +1300,26 @@ void Real8Shell::renderOptionsMenu()
 // DATA & HELPERS
 // --------------------------------------------------------------------------
 
+void Real8Shell::updateLibraryScan()
+{
+    while (std::unique_ptr<LibraryScan> res = libraryScanner->poll()) {
+        library.store(host, *res);
+        if (res->changed && (res->path == previewLabelPath || previewCache.contains(res->path))) {
+            if (res->hasLabel) previewCache.put(res->path, res->label);
+            else previewCache.put(res->path, nullptr);
+        }
+        if (res->changed && res->path == previewLabelPath) {
+            if (res->hasLabel) {
+                Real8Library::unpackLabel(res->label, preview_ram);
+                has_preview = true;
+            } else {
+                clearPreview();
+            }
+        }
+    }
+    if (libraryScanner->idle()) library.save(host);
+}
+
 void Real8Shell::refreshGameList(std::string selectPath)
 {
     std::string previousPath = selectPath;
@@ -1357,11 +1407,26 @@ void Real8Shell::refreshGameList(std::string selectPath)
             list.push_back(e);
         };
 
+        std::vector<std::string> cartPaths;
         for (const auto &raw : files) {
             std::string n = normalizePath(raw);
             if (n.empty()) continue;
             if (!isGameFile(n)) continue;
             addFileEntry(n);
+            cartPaths.push_back("/" + n);
+        }
+        library.sync(host, cartPaths);
+        library.save(host);
+
+        // Re-verify the whole listing in the background, this folder first.
+        libraryScanner->cancelAll();
+        for (const auto &e : vfs[""]) {
+            const LibraryEntry *info = e.isFolder ? nullptr : library.find(e.path);
+            if (info) libraryScanner->submit(*info, false);
+        }
+        for (const auto &path : cartPaths) {
+            const LibraryEntry *info = library.find(path);
+            if (info && path.find('/', 1) != std::string::npos) libraryScanner->submit(*info, false);
         }
 
         for (auto e : vfs[""]) {
@@ -1557,31 +1622,67 @@ void Real8Shell::parseJsonToVFS(const std::string &json)
 // PREVIEW & GRAPHICS HELPERS
 // --------------------------------------------------------------------------
 
-void Real8Shell::loadPreview(const uint8_t *data, size_t size)
+void Real8Shell::cachePreviewLabel(const std::string &key, const uint8_t *data, size_t size)
+{
+    // Only the label rows are inflated; the cart payload is skipped.
+    std::vector<uint8_t> label(128 * 128);
+    uint8_t (*rows)[128] = (uint8_t (*)[128])label.data();
+    bool isPng = size > 8 && data[0] == 0x89 && data[1] == 'P';
+    bool ok = false;
+    if (isPng) {
+        ok = Real8PngCart::Decode(data, size, nullptr, 0, nullptr, rows, find_closest_p8_color);
+    } else {
+        P8TextSections sections;
+        Real8CartLoader::SplitTextSections((const char *)data, size, sections);
+        ok = Real8CartLoader::DecodeTextLabel(sections.label, rows);
+    }
+    if (!ok) {
+        previewCache.put(key, nullptr);
+        return;
+    }
+    uint8_t packed[Real8Library::LABEL_BYTES];
+    Real8Library::packLabel(rows, packed);
+    previewCache.put(key, packed);
+}
+
+bool Real8Shell::showCachedPreview(const std::string &key)
 {
-    unsigned w, h;
-    unsigned char *image = nullptr;
-    unsigned error = lodepng_decode32(&image, &w, &h, data, size);
+    bool hasLabel = false;
+    if (!previewCache.get(key, preview_ram, hasLabel)) return false;
+    if (hasLabel) has_preview = true;
+    else clearPreview();
+    return true;
+}
 
-    if (error || !image) { if (image) free(image); clearPreview(); return; }
+void Real8Shell::prefetchPreviews()
+{
+    // One label read per frame, nearest neighbours first.
+    while (prefetchStep < PREVIEW_PREFETCH * 2) {
+        int step = prefetchStep++;
+        int offset = (step / 2) + 1;
+        int idx = (step & 1) ? fileSelection - offset : fileSelection + offset;
+        if (idx < 0 || idx >= (int)gameList.size()) continue;
+
+        const GameEntry &e = gameList[idx];
+        if (e.isFolder || e.isRemote || previewCache.contains(e.path)) continue;
+        const LibraryEntry *info = library.find(e.path);
+        if (!info) continue;
+        if (!info->scanned) {
+            libraryScanner->submit(*info, true);
+            continue;
+        }
 
-    memset(preview_ram, 0, sizeof(preview_ram));
-    int src_offset_x = 16;
-    int src_offset_y = 25;
-
-    for (int y = 0; y < 128; ++y) {
-        for (int x = 0; x < 128; ++x) {
-            int sx = src_offset_x + x;
-            int sy = src_offset_y + y;
-            if (sx < w && sy < h) {
-                size_t idx = (sy * w + sx) * 4;
-                if (image[idx + 3] < 128) preview_ram[y][x] = 0;
-                else preview_ram[y][x] = find_closest_p8_color(image[idx], image[idx+1], image[idx+2]);
-            }
+        std::vector<uint8_t> label(128 * 128);
+        uint8_t (*rows)[128] = (uint8_t (*)[128])label.data();
+        if (library.readLabel(host, *info, rows)) {
+            uint8_t packed[Real8Library::LABEL_BYTES];
+            Real8Library::packLabel(rows, packed);
+            previewCache.put(e.path, packed);
+        } else {
+            previewCache.put(e.path, nullptr);
         }
+        return;
     }
-    free(image);
-    has_preview = true;
 }
 
 void Real8Shell::clearPreview() { has_preview = false; memset(preview_ram, 0, sizeof(preview_ram)); }
@@ -1,11 +1,13 @@
 #pragma once
 #include "real8_vm.h"
+#include "real8_library.h"
 #include <vector>
 #include <string>
 #include <set>
 #include <map>
 #include <atomic>
 #include <thread>
+#include <memory>
 
 enum ShellState {
     STATE_BOOT,
@@ -29,7 +31,6 @@ struct GameEntry {
     bool isRemote;
     bool isFavorite;
     bool isFolder;
-    std::vector<uint8_t> cacheData;
 
     bool operator<(const GameEntry &other) const {
         if (isFolder != other.isFolder) return isFolder > other.isFolder;
@@ -87,7 +88,9 @@ private:
     // --- Graphics/Preview helpers ---
     void drawStarfield();
     static void drawStarfieldHook(void* user, Real8VM* vm);
-    void loadPreview(const uint8_t *data, size_t size);
+    void cachePreviewLabel(const std::string &key, const uint8_t *data, size_t size);
+    bool showCachedPreview(const std::string &key);
+    void prefetchPreviews();
     void clearPreview();
     void drawPreview(int x, int y, bool dim);
     void renderTopPreview3ds(const char *statusText = nullptr);
@@ -97,7 +100,15 @@ private:
     std::map<std::string, std::vector<GameEntry>> vfs;
     std::vector<GameEntry> gameList;
     std::set<std::string> favorites;
-    std::map<std::string, std::vector<uint8_t>> previewCache;
+    // Decoded labels (4bpp) for local and remote entries, LRU under a byte budget.
+    static constexpr size_t PREVIEW_CACHE_BYTES = 2 * 1024 * 1024;
+    static constexpr size_t PREVIEW_CACHE_BYTES_3DS = 256 * 1024;
+    static constexpr int PREVIEW_PREFETCH = 4; // entries on each side of the cursor
+    Real8LabelCache previewCache;
+    int prefetchStep = 0;
+    Real8Library library;
+    std::unique_ptr<Real8LibraryScanner> libraryScanner;
+    std::string previewLabelPath;
     GameEntry targetGame;
     
     // --- Preview RAM ---
@@ -141,6 +152,7 @@ private:
     void startAsyncDownload(AsyncDownload &task, const std::string &url, const std::string &path);
     void updateAsyncDownloads();
     bool isPreviewDownloadActiveFor(const std::string &url) const;
+    void updateLibraryScan();
 
     AsyncDownload repoDownload;
     AsyncDownload previewDownload;
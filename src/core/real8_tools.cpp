@@ -3,6 +3,7 @@
 #endif
 
 #include "real8_tools.h"
+#include "real8_compression.h"
 #include <sstream>
 #include <iomanip>
 #include <cmath>
@@ -13,6 +14,9 @@
 #include <vector>
 #include <filesystem>
 #include <cctype>
+#include <memory>
+#include <thread>
+#include <atomic>
 
 // Include lodePNG here so the main VM doesn't need to depend on it
 #include <lodePNG.h>
@@ -448,69 +452,6 @@ bool Real8Tools::InjectBinaryMod(Real8VM* vm, IReal8Host* host, const std::strin
 // --------------------------------------------------------------------------
 
 namespace {
-    class PxaBitWriter {
-    public:
-        void writeBits(uint32_t value, int count) {
-            for (int i = 0; i < count; ++i) {
-                uint8_t bit = (value >> i) & 1u;
-                current |= (uint8_t)(bit << bitCount);
-                bitCount++;
-                if (bitCount == 8) {
-                    bytes.push_back(current);
-                    current = 0;
-                    bitCount = 0;
-                }
-            }
-        }
-
-        void flush() {
-            if (bitCount > 0) {
-                bytes.push_back(current);
-                current = 0;
-                bitCount = 0;
-            }
-        }
-
-        std::vector<uint8_t> bytes;
-
-    private:
-        uint8_t current = 0;
-        int bitCount = 0;
-    };
-
-    static bool buildPxaRaw(const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
-        if (input.size() > 0xFFFF) return false;
-
-        PxaBitWriter bw;
-        // Raw block header: block(0) + offset_bits selector (10) + offset=1 (value 0)
-        bw.writeBits(0, 1);
-        bw.writeBits(1, 1);
-        bw.writeBits(0, 1);
-        bw.writeBits(0, 10);
-        for (uint8_t b : input) {
-            bw.writeBits(b, 8);
-        }
-        bw.writeBits(0, 8); // Raw block terminator
-        bw.flush();
-
-        if (bw.bytes.size() > 0xFFFF) return false;
-
-        output.clear();
-        output.reserve(8 + bw.bytes.size());
-        output.push_back(0x00);
-        output.push_back('p');
-        output.push_back('x');
-        output.push_back('a');
-        uint16_t destLen = (uint16_t)input.size();
-        output.push_back((uint8_t)((destLen >> 8) & 0xFF));
-        output.push_back((uint8_t)(destLen & 0xFF));
-        uint16_t compLen = (uint16_t)bw.bytes.size();
-        output.push_back((uint8_t)((compLen >> 8) & 0xFF));
-        output.push_back((uint8_t)(compLen & 0xFF));
-        output.insert(output.end(), bw.bytes.begin(), bw.bytes.end());
-        return true;
-    }
-
     static bool buildLegacyRaw(const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
         if (input.size() > 0xFFFF) return false;
 
@@ -1191,6 +1132,225 @@ void Real8Tools::ExportMusic(Real8VM* vm, IReal8Host* host, const std::string &o
     host->delayMs(500);
 }
 
+// --------------------------------------------------------------------------
+// OFFLINE AUDIO RENDER
+// --------------------------------------------------------------------------
+// Drives private AudioEngine instances sample-by-sample (no host clock), so
+// renders are deterministic and run as fast as the CPU allows. Each song or
+// stem is an independent job; jobs are spread across hardware threads. The
+// engines only read sfx_ram/music_ram from the VM, so sharing it is safe.
+
+static constexpr int kRenderChunk = 64;          // samples between end checks
+static constexpr int kMaxSongSeconds = 600;
+static constexpr int kMaxSfxSeconds = 30;
+
+struct AudioRenderJob {
+    bool music = true;
+    int index = 0;            // start pattern or sfx id
+    uint8_t mask = 0x0f;      // channels mixed into this file
+    std::string path;
+    std::unique_ptr<AudioEngine> engine;
+    std::vector<int16_t> pcm;
+};
+
+static bool musicPatternEmpty(const uint8_t* music_ram, int pat)
+{
+    for (int i = 0; i < 4; i++) {
+        if ((music_ram[pat * 4 + i] & 0x40) == 0) return false;
+    }
+    return true;
+}
+
+static bool sfxSilent(const uint8_t* sfx_ram, int id)
+{
+    const uint8_t* sfx = sfx_ram + id * 68;
+    for (int row = 0; row < 32; row++) {
+        if ((sfx[row * 2 + 1] >> 2) & 0x7) return false;
+    }
+    return true;
+}
+
+static void renderMusicJob(AudioRenderJob& job)
+{
+    AudioEngine& eng = *job.engine;
+    eng.play_music(job.index, 0, 0x0f);
+
+    const int maxSamples = (int)(AudioEngine::SAMPLE_RATE * kMaxSongSeconds);
+    if (job.index < 0 || job.index >= 64 || musicPatternEmpty(eng.vm->music_ram, job.index)) return;
+    bool visited[64] = {};
+    visited[job.index] = true;
+    bool lastPattern = false;
+    int played = eng.music_patterns_played;
+    int16_t chunk[kRenderChunk];
+
+    while ((int)job.pcm.size() < maxSamples) {
+        // A chunk never spans more than one tick; step single samples when
+        // the next tick starts a pattern so the cut lands on the boundary.
+        int n = (eng.music_tick_timer <= 1) ? 1 : kRenderChunk;
+        eng.generateSamples(chunk, n);
+
+        if (eng.music_patterns_played != played) {
+            played = eng.music_patterns_played;
+            if (lastPattern) break;
+            // The tick moved music_pattern on to whatever follows the pattern
+            // that just started. Finish this one, then stop if the chain loops
+            // back or runs into an empty pattern.
+            int next = eng.music_pattern;
+            if (next < 0 || next >= 64 || visited[next] ||
+                musicPatternEmpty(eng.vm->music_ram, next)) {
+                lastPattern = true;
+            } else {
+                visited[next] = true;
+            }
+        }
+
+        job.pcm.insert(job.pcm.end(), chunk, chunk + n);
+
+        if (!eng.music_playing) {
+            bool busy = false;
+            for (int c = 0; c < AudioEngine::CHANNELS; c++) {
+                if (eng.channels[c].sfx_id != -1) busy = true;
+            }
+            if (!busy) break;
+        }
+    }
+}
+
+static void renderSfxJob(AudioRenderJob& job)
+{
+    AudioEngine& eng = *job.engine;
+    eng.play_sfx(job.index, 0);
+
+    // Looping sfx: play the intro and two passes of the loop.
+    const Channel& ch = eng.channels[0];
+    int maxSamples = (int)(AudioEngine::SAMPLE_RATE * kMaxSfxSeconds);
+    if (ch.loop_active) {
+        int ticks = (32 + (32 - ch.loop_start)) * ch.speed;
+        maxSamples = std::min(maxSamples, (int)((float)ticks * AudioEngine::SAMPLE_RATE / 120.0f));
+    }
+
+    int16_t chunk[kRenderChunk];
+    while ((int)job.pcm.size() < maxSamples && eng.channels[0].sfx_id != -1) {
+        eng.generateSamples(chunk, kRenderChunk);
+        job.pcm.insert(job.pcm.end(), chunk, chunk + kRenderChunk);
+    }
+}
+
+static std::vector<uint8_t> buildWav16Mono(const std::vector<int16_t>& pcm, int sampleRate)
+{
+    const uint32_t dataBytes = (uint32_t)(pcm.size() * sizeof(int16_t));
+    std::vector<uint8_t> f;
+    f.reserve(44 + dataBytes);
+    auto put32 = [&](uint32_t v) { for (int i = 0; i < 4; i++) f.push_back((uint8_t)(v >> (i * 8))); };
+    auto put16 = [&](uint16_t v) { f.push_back((uint8_t)v); f.push_back((uint8_t)(v >> 8)); };
+
+    f.insert(f.end(), {'R','I','F','F'}); put32(36 + dataBytes);
+    f.insert(f.end(), {'W','A','V','E'});
+    f.insert(f.end(), {'f','m','t',' '}); put32(16);
+    put16(1);                               // PCM
+    put16(1);                               // mono
+    put32((uint32_t)sampleRate);
+    put32((uint32_t)sampleRate * 2);        // byte rate
+    put16(2);                               // block align
+    put16(16);                              // bits per sample
+    f.insert(f.end(), {'d','a','t','a'}); put32(dataBytes);
+    for (int16_t s : pcm) put16((uint16_t)s);
+    return f;
+}
+
+int Real8Tools::ExportAudio(Real8VM* vm, IReal8Host* host, const std::string &outputFolder, AudioExportMode mode)
+{
+    if (vm->currentGameId.empty() || !vm->ram) return 0;
+
+    std::string cleanName = GetActiveCartName(vm);
+    if (cleanName.empty()) cleanName = "cart";
+    host->log("[EXPORT] Rendering Audio: %s (%s)", cleanName.c_str(),
+              (mode == AudioExportMode::Stems) ? "stems" : "mix");
+
+    std::vector<AudioRenderJob> jobs;
+    auto addJob = [&](bool music, int index, uint8_t mask, const std::string& suffix) {
+        AudioRenderJob job;
+        job.music = music;
+        job.index = index;
+        job.mask = mask;
+        job.path = outputFolder + "/" + cleanName + suffix + ".wav";
+        // Engines are set up here, on the calling thread, so the shared
+        // audio lookup tables are initialised before any worker starts.
+        job.engine.reset(new AudioEngine());
+        job.engine->init(vm);
+        job.engine->offline_render = true;
+        job.engine->channel_mask = mask;
+        jobs.push_back(std::move(job));
+    };
+
+    // Song = a chain that isn't entered by falling through from the pattern before.
+    for (int pat = 0; pat < 64; pat++) {
+        if (musicPatternEmpty(vm->music_ram, pat)) continue;
+        if (pat > 0) {
+            const uint8_t* prev = vm->music_ram + (pat - 1) * 4;
+            bool prevEnds = musicPatternEmpty(vm->music_ram, pat - 1) || (prev[1] & 0x80) || (prev[2] & 0x80);
+            if (!prevEnds) continue;
+        }
+        char suffix[32];
+        if (mode == AudioExportMode::Stems) {
+            for (int c = 0; c < AudioEngine::CHANNELS; c++) {
+                snprintf(suffix, sizeof(suffix), "_music_%02d_ch%d", pat, c);
+                addJob(true, pat, (uint8_t)(1 << c), suffix);
+            }
+        } else {
+            snprintf(suffix, sizeof(suffix), "_music_%02d", pat);
+            addJob(true, pat, 0x0f, suffix);
+        }
+    }
+
+    for (int id = 0; id < 64; id++) {
+        if (sfxSilent(vm->sfx_ram, id)) continue;
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), "_sfx_%02d", id);
+        addJob(false, id, 0x0f, suffix);
+    }
+
+    unsigned long startMs = host->getMillis();
+
+    unsigned workerCount = std::thread::hardware_concurrency();
+    if (workerCount == 0) workerCount = 1;
+    if (workerCount > jobs.size()) workerCount = (unsigned)jobs.size();
+
+    std::atomic<size_t> nextJob{0};
+    auto worker = [&]() {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+            if (jobs[i].music) renderMusicJob(jobs[i]);
+            else renderSfxJob(jobs[i]);
+            jobs[i].engine.reset();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; i++) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+
+    // Host file I/O stays on the calling thread.
+    const int wavRate = (AudioEngine::SAMPLE_RATE_NUM + AudioEngine::SAMPLE_RATE_DEN / 2) / AudioEngine::SAMPLE_RATE_DEN;
+    int written = 0;
+    size_t totalSamples = 0;
+    for (auto& job : jobs) {
+        if (job.pcm.empty()) continue;
+        std::vector<uint8_t> wav = buildWav16Mono(job.pcm, wavRate);
+        if (host->saveState(job.path.c_str(), wav.data(), wav.size())) written++;
+        else host->log("[EXPORT] Failed to save %s", job.path.c_str());
+        totalSamples += job.pcm.size();
+    }
+
+    unsigned long elapsed = host->getMillis() - startMs;
+    host->log("[EXPORT] Audio: %d files, %.1fs of audio in %lums on %u threads",
+              written, (double)totalSamples / AudioEngine::SAMPLE_RATE, elapsed, workerCount);
+
+    vm->gpu.renderMessage("SYSTEM", written > 0 ? "AUDIO EXPORTED" : "NO AUDIO", 11);
+    vm->show_frame();
+    host->delayMs(500);
+    return written;
+}
+
 bool Real8Tools::ExportGamecard(Real8VM* vm, IReal8Host* host, const std::string &outputFile,
                                 const std::string &title, const std::string &author,
                                 const std::string &coverArtPath,
@@ -1223,21 +1383,32 @@ bool Real8Tools::ExportGamecard(Real8VM* vm, IReal8Host* host, const std::string
 
     std::vector<uint8_t> luaBytes(lua.begin(), lua.end());
     std::vector<uint8_t> code;
+    const char *method = "PXA";
+    unsigned long startMs = host->getMillis();
     if (compression == GamecardCompression::Legacy) {
+        method = "Legacy";
         if (!buildLegacyRaw(luaBytes, code)) {
             host->log("[EXPORT] Failed to compress LUA with Legacy.");
             return false;
         }
     } else {
-        if (!buildPxaRaw(luaBytes, code)) {
+        bool fast = (compression == GamecardCompression::PxaFast);
+        method = fast ? "PXA fast" : "PXA";
+        if (!compress_pico8_code_pxa(luaBytes.data(), (int)luaBytes.size(), code, fast ? PxaLevel::Fast : PxaLevel::Best)) {
             host->log("[EXPORT] Failed to compress LUA with PXA.");
             return false;
         }
     }
+    unsigned long elapsed = host->getMillis() - startMs;
+    host->log("[EXPORT] %s: %u -> %u bytes (%.1f%%) in %lums (%.0f KB/s)", method,
+              (unsigned)luaBytes.size(), (unsigned)code.size(),
+              luaBytes.empty() ? 0.0 : 100.0 * code.size() / luaBytes.size(), elapsed,
+              luaBytes.size() / 1024.0 / ((elapsed ? elapsed : 1) / 1000.0));
 
     const size_t codeCapacity = 0x8000 - 0x4300;
     if (code.size() > codeCapacity) {
-        host->log("[EXPORT] Compressed LUA exceeds cart capacity.");
+        host->log("[EXPORT] Compressed LUA exceeds cart capacity (%u > %u bytes).",
+                  (unsigned)code.size(), (unsigned)codeCapacity);
         return false;
     }
 
@@ -44,8 +44,15 @@ public:
     static void ExportStaticVars(Real8VM* vm, IReal8Host* host, const std::string &outputFolder);
     static void ExportStaticVars(Real8VM* vm, IReal8Host* host, const std::string &outputFolder, const std::vector<StaticVarEntry>& entries);
     static void ExportMusic(Real8VM* vm, IReal8Host* host, const std::string &outputFolder);
+    enum class AudioExportMode {
+        Mix,    // one WAV per song and per sfx
+        Stems   // one WAV per song channel (sfx are always mixed)
+    };
+    // Offline, faster-than-real-time render to 16-bit WAV. Returns files written.
+    static int ExportAudio(Real8VM* vm, IReal8Host* host, const std::string &outputFolder, AudioExportMode mode);
     enum class GamecardCompression {
-        Pxa,
+        Pxa,        // best ratio
+        PxaFast,    // quicker match search for interactive use
         Legacy
     };
     static bool ExportGamecard(Real8VM* vm, IReal8Host* host, const std::string &outputFile,
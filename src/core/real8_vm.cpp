@@ -845,10 +845,27 @@ void Real8VM::rebootVM()
     
     // Reset Lua
     clearLuaRefs();
+#if REAL8_LUA_POOL
+    if (L && host) {
+        const Real8LuaHeap::Stats hs = luaHeap.stats();
+        host->log("[VM] Lua heap: peak %uKB, arena %uKB in %u chunks, %uKB live, %uKB free (%d%% frag), %uKB large",
+                  (unsigned)(hs.peakBytes / 1024), (unsigned)(hs.arenaBytes / 1024), (unsigned)hs.chunkCount,
+                  (unsigned)(hs.usedBytes / 1024), (unsigned)(hs.freeBytes / 1024), hs.fragmentationPct(),
+                  (unsigned)(hs.largeBytes / 1024));
+    }
+#endif
     if (L) { lua_close(L); L = nullptr; }
+#if REAL8_LUA_POOL
+    // Everything the old cart allocated goes back in one piece per chunk
+    luaHeap.release();
+#endif
     gbaLog("[BOOT] REBOOT LUA CLOSED");
     gbaLog("[BOOT] REBOOT LUA NEWSTATE");
+#if REAL8_LUA_POOL
+    L = luaL_newstatef(Real8LuaHeap::alloc, &luaHeap);
+#else
     L = luaL_newstate();
+#endif
     if (L) {
         gbaLog("[BOOT] REBOOT LUA NEWSTATE OK");
     } else {
@@ -857,6 +874,9 @@ void Real8VM::rebootVM()
     
     reset_requested = false;
     next_cart_path = "";
+    gcIdleCycle = false;
+    gcIdleStepMs = 0;
+    gcIdleReserveMs = 0;
 
     // Run lib loading + API registration in protected calls.
     if (L) {
@@ -1011,6 +1031,19 @@ void Real8VM::resetInputState()
 
 void Real8VM::runFrame()
 {
+    // Whole-frame clock for the idle collector: a frame that ran past its
+    // tick after idle steps had a share in it makes them keep further back.
+    // The clock only has whole milliseconds, so a 60 Hz frame reads 16 or
+    // 17; one more than the real period is still on time.
+    if (host) {
+        const unsigned long now = host->getMillis();
+        const long elapsed = (long)(now - frameBeginMs);
+        const bool overran = gcIdleRan && elapsed * host_tick_hz > 1000 + host_tick_hz;
+        if (overran && gcIdleReserveMs < 500 / host_tick_hz) gcIdleReserveMs++;
+        if ((++gcIdleFrames & 63) == 0 && gcIdleReserveMs > 0 && !overran) gcIdleReserveMs--;
+        gcIdleRan = false;
+        frameBeginMs = now;
+    }
     const bool isLibretro = isLibretroPlatform;
     const bool isGba = isGbaPlatform;
     if (ram) {
@@ -1056,6 +1089,9 @@ void Real8VM::runFrame()
         shouldRunLua = false;
     }
 
+    const bool skipDraw = skip_draw_once;
+    skip_draw_once = false;
+
     unsigned long now_ms = 0;
     bool splashActive = false;
     if (bootSplashActive && host) {
@@ -1079,11 +1115,7 @@ void Real8VM::runFrame()
 #else
     #if REAL8_HAS_LIBRETRO_BUFFERS
         if (isLibretro) {
-            // FIX: Calculate samples based on actual rate (22050 / 60 = 367.5)
-            int samples_needed = (int)(AudioEngine::SAMPLE_RATE / 60.0f) + 1; 
-            if (samples_needed > 2048) samples_needed = 2048;
-            audio.generateSamples(static_audio_buffer, samples_needed);
-            if (host) host->pushAudio(static_audio_buffer, samples_needed);
+            renderLibretroAudio();
         } else if (!gbaAudioDisabled) {
             audio.update(host);
         }
@@ -1103,7 +1135,7 @@ void Real8VM::runFrame()
 
 #if REAL8_HAS_LIBRETRO_BUFFERS
     if (!isGba) {
-        frame_is_dirty = true; // MARK FRAME AS DIRTY
+        frame_is_dirty = !skipDraw; // MARK FRAME AS DIRTY
     }
 #endif
 
@@ -1312,8 +1344,8 @@ void Real8VM::runFrame()
     }
 #endif
 
-    // _draw
-    if (lua_ref_draw != LUA_NOREF) {
+    // _draw (PICO-8 also drops _draw, never _update, when it falls behind)
+    if (lua_ref_draw != LUA_NOREF && !skipDraw) {
         REAL8_PROFILE_BEGIN(this, kProfileDraw);
         real8_set_last_lua_phase("_draw");
         lua_rawgeti(L, LUA_REGISTRYINDEX, lua_ref_draw);
@@ -1364,10 +1396,7 @@ void Real8VM::runFrame()
     if (!gbaAudioDisabled) {
     #if REAL8_HAS_LIBRETRO_BUFFERS
         if (isLibretro) {
-            int samples_needed = (int)(AudioEngine::SAMPLE_RATE / 60.0f) + 1; 
-            if (samples_needed > 2048) samples_needed = 2048;
-            audio.generateSamples(static_audio_buffer, samples_needed);
-            if (host) host->pushAudio(static_audio_buffer, samples_needed);
+            renderLibretroAudio();
         } else {
             audio.update(host);
         }
@@ -1378,8 +1407,91 @@ void Real8VM::runFrame()
 #endif
 
     mouse_wheel_event = 0;
+
+    // The rest of this host tick belongs to the collector
+    stepIdleGC(frameBeginMs, 1000 / host_tick_hz - gcIdleReserveMs);
+}
+
+// --------------------------------------------------------------------------
+// GC PACING
+// --------------------------------------------------------------------------
+// Lua's own pacing (pause 200%) steps the collector from inside whatever
+// cart code happens to allocate, and its atomic phase can land in the
+// middle of _draw. Instead the VM starts a cycle once the heap has grown a
+// quarter past the last live size and advances it in the slack after the
+// frame. The window runs from the top of runFrame to the host tick, less a
+// reserve that grows whenever a frame with idle steps overran, which covers
+// the present that follows runFrame. Presents are not timed: on vsync hosts
+// that would count the wait for vsync as cost and the window would never open.
+// The stock trigger stays armed as a safety net for carts that never
+// leave any slack, and every idle step pays down its debt.
+static const int kGcIdleMarginMs = 2;
+static const int kGcIdleMaxSteps = 4096;
+static const size_t kGcIdleMinGrowth = 4 * 1024;
+
+static size_t lua_heap_bytes(lua_State* L)
+{
+    return (size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + (size_t)lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+void Real8VM::stepIdleGC(unsigned long frameStartMs, int budgetMs)
+{
+    if (!L || !host || budgetMs <= kGcIdleMarginMs) return;
+
+    if (!gcIdleCycle) {
+        const size_t live = (size_t)lua_gc(L, LUA_GCESTIMATE, 0);
+        if (live > 0 && lua_heap_bytes(L) < live + live / 4 + kGcIdleMinGrowth) return;
+    }
+
+    // A single step can be long (a big table, the atomic phase), so stop
+    // early by the slowest step seen lately rather than overrun the frame.
+    const unsigned long deadline = frameStartMs + (unsigned long)(budgetMs - kGcIdleMarginMs);
+    unsigned long now = host->getMillis();
+    for (int i = 0; i < kGcIdleMaxSteps; i++) {
+        if ((long)(now + (unsigned long)gcIdleStepMs - deadline) >= 0) break;
+        gcIdleCycle = true;
+        gcIdleRan = true;
+        const int done = lua_gc(L, LUA_GCSTEP, 0);
+        const unsigned long after = host->getMillis();
+        const int took = (int)(after - now);
+        if (took > gcIdleStepMs) gcIdleStepMs = took;
+        now = after;
+        if (done) {
+            gcIdleCycle = false; // cycle finished; wait for the heap to grow again
+            break;
+        }
+    }
+    if (gcIdleStepMs > 0 && (gcIdleDecay = (gcIdleDecay + 1) & 63) == 0) gcIdleStepMs--;
+}
+
+size_t Real8VM::luaLiveBytes() const
+{
+    if (!L) return 0;
+    const size_t heap = lua_heap_bytes(L);
+    const size_t live = (size_t)lua_gc(L, LUA_GCESTIMATE, 0);
+    return (live > 0 && live < heap) ? live : heap;
 }
 
+#if !defined(__GBA__)
+static int append_bytecode(lua_State* L, const void* p, size_t sz, void* ud)
+{
+    (void)L;
+    std::vector<uint8_t>* out = (std::vector<uint8_t>*)ud;
+    out->insert(out->end(), (const uint8_t*)p, (const uint8_t*)p + sz);
+    return 0;
+}
+
+uint64_t Real8VM::cartCodeKey(const GameData& game) const
+{
+    if (game.content_hash == 0) return 0;
+    // Text carts go through string normalization first, so the same bytes
+    // under a .p8 path compile to a different chunk.
+    const bool text = !currentCartPath.empty() && is_text_cart_path(currentCartPath);
+    uint64_t key = game.content_hash ^ (text ? 0x9E3779B97F4A7C15ULL : 0);
+    return key ? key : 1;
+}
+#endif
+
 bool Real8VM::loadGame(const GameData& game)
 {
     const bool isGba = isGbaPlatform;
@@ -1461,8 +1573,25 @@ bool Real8VM::loadGame(const GameData& game)
         host->log("[BOOT] Lua bytes: %lu", (unsigned long)lua_len);
     }
 
+    // Chunk precompiled by the cart packer (standalone exports ship it
+    // instead of the source).
+    const char* aot_chunk = nullptr;
+    size_t aot_len = 0;
+#if defined(__GBA__)
+    aot_chunk = reinterpret_cast<const char*>(game.bytecode_ptr);
+    aot_len = game.bytecode_ptr ? game.bytecode_size : 0;
+#else
+    if (lua_len == 0 && !game.bytecode.empty()) {
+        aot_chunk = reinterpret_cast<const char*>(game.bytecode.data());
+        aot_len = game.bytecode.size();
+    }
+#endif
+    if (useGbaInitWatchdog && host && aot_len > 0) {
+        host->log("[BOOT] Lua chunk bytes: %lu", (unsigned long)aot_len);
+    }
+
     std::string normalized_lua;
-    if (lua_len > 0) {
+    if (lua_len > 0 || aot_len > 0) {
 #if !defined(__GBA__)
         if (!currentCartPath.empty() && is_text_cart_path(currentCartPath))
         {
@@ -1489,11 +1618,56 @@ bool Real8VM::loadGame(const GameData& game)
         }
 
         if (useGbaInitWatchdog && host) host->log("[BOOT] Lua load");
-        if (luaL_loadbuffer(L, lua_src, lua_len, "cart") != LUA_OK) {
-            const char* err = lua_tostring(L, -1);
-            setLastError("LUA PARSE", "%s", err ? err : "(unknown parse error)");
-            lua_pop(L, 2); // error + traceback
-            return false;
+        bool loaded = false;
+        if (aot_len > 0) {
+            if (luaL_loadbuffer(L, aot_chunk, aot_len, "cart") != LUA_OK) {
+                const char* err = lua_tostring(L, -1);
+                setLastError("LUA LOAD", "%s", err ? err : "(bad precompiled chunk)");
+                lua_pop(L, 2); // error + traceback
+                return false;
+            }
+            loaded = true;
+        }
+#if !defined(__GBA__)
+        // Otherwise prefer a chunk from the cart cache, or the one kept from
+        // the previous load of this same cart.
+        const uint64_t codeKey = loaded ? 0 : cartCodeKey(game);
+        if (codeKey != 0) {
+            if (!game.bytecode.empty() && game.bytecode_key == codeKey && cartBytecodeKey != codeKey) {
+                cartBytecode = game.bytecode;
+                cartBytecodeKey = codeKey;
+                cartBytecodeFresh = false;
+            }
+            if (cartBytecodeKey == codeKey && !cartBytecode.empty()) {
+                if (luaL_loadbuffer(L, (const char*)cartBytecode.data(), cartBytecode.size(), "cart") == LUA_OK) {
+                    loaded = true;
+                } else {
+                    lua_pop(L, 1);
+                    cartBytecode.clear();
+                }
+            }
+        }
+#endif
+        if (!loaded) {
+#if !defined(__GBA__)
+            cartBytecode.clear();
+            cartBytecodeKey = 0;
+            cartBytecodeFresh = false;
+#endif
+            if (luaL_loadbuffer(L, lua_src, lua_len, "cart") != LUA_OK) {
+                const char* err = lua_tostring(L, -1);
+                setLastError("LUA PARSE", "%s", err ? err : "(unknown parse error)");
+                lua_pop(L, 2); // error + traceback
+                return false;
+            }
+#if !defined(__GBA__)
+            if (codeKey != 0 && lua_dump(L, append_bytecode, &cartBytecode) == 0) {
+                cartBytecodeKey = codeKey;
+                cartBytecodeFresh = true;
+            } else {
+                cartBytecode.clear();
+            }
+#endif
         }
         if (useGbaInitWatchdog && host) host->log("[BOOT] Lua load ok");
 
@@ -1703,6 +1877,22 @@ void Real8VM::updatePaletteLUT() {
         palette_lut[i] = (c[0] << 16) | (c[1] << 8) | c[2];
     }
 }
+
+// Exact per-frame audio for the libretro frontend: carry the fractional
+// remainder between frames instead of rounding every frame up.
+void Real8VM::renderLibretroAudio() {
+    const int64_t denom = (int64_t)AudioEngine::SAMPLE_RATE_DEN * LIBRETRO_FPS;
+    libretro_audio_accum += AudioEngine::SAMPLE_RATE_NUM;
+    int samples_needed = (int)(libretro_audio_accum / denom);
+    libretro_audio_accum -= (int64_t)samples_needed * denom;
+
+    const int max_samples = (int)(sizeof(static_audio_buffer) / sizeof(static_audio_buffer[0]));
+    if (samples_needed > max_samples) samples_needed = max_samples;
+    if (samples_needed <= 0) return;
+
+    audio.generateSamples(static_audio_buffer, samples_needed);
+    if (host) host->pushAudio(static_audio_buffer, samples_needed);
+}
 #endif
 
 void Real8VM::show_frame()
@@ -2256,9 +2446,8 @@ void Real8VM::run_menu_item(int index)
 
 #if !defined(__GBA__)
 size_t Real8VM::getStateSize() {
-    // RAM (32k) + Cart Data (256b) + Audio State (approx ~200-300 bytes)
-    // We add sizeof(AudioStateSnapshot) to ensure exact sizing.
-    return 0x8000 + sizeof(cart_data_ram) + sizeof(AudioStateSnapshot); 
+    // RAM (32k) + Cart Data (256b) + compact Audio State (fixed size per version)
+    return 0x8000 + sizeof(cart_data_ram) + AudioEngine::STATE_SIZE; 
 }
 
 bool Real8VM::serialize(void* data, size_t size) {
@@ -2275,8 +2464,7 @@ bool Real8VM::serialize(void* data, size_t size) {
     ptr += sizeof(cart_data_ram);
 
     // 3. Copy Audio State (CRITICAL FIX)
-    AudioStateSnapshot audioState = audio.getState();
-    memcpy(ptr, &audioState, sizeof(AudioStateSnapshot));
+    if (audio.serializeState(ptr, AudioEngine::STATE_SIZE) != AudioEngine::STATE_SIZE) return false;
     
     return true;
 }
@@ -2297,11 +2485,13 @@ bool Real8VM::unserialize(const void* data, size_t size) {
     memcpy(cart_data_ram, ptr, sizeof(cart_data_ram)); 
     ptr += sizeof(cart_data_ram);
 
-    // 3. Restore Audio State
-    AudioStateSnapshot audioState;
-    memcpy(&audioState, ptr, sizeof(AudioStateSnapshot));
-    audio.setState(audioState);
-    ptr += sizeof(AudioStateSnapshot);
+    // 3. Restore Audio State (states from older builds keep RAM, drop audio)
+    if (!audio.unserializeState(ptr, AudioEngine::STATE_SIZE)) {
+        LOG_ONCE(audio_state_version, "Savestate audio block not recognised; audio state reset");
+        audio.play_music(-1);
+        audio.play_sfx(-1, -1);
+    }
+    ptr += AudioEngine::STATE_SIZE;
 
     // 4. Sync Hardware State from RAM (GPU, Camera, Palettes)
     // (Existing sync logic follows here...)
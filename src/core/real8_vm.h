@@ -18,6 +18,7 @@
 
 #include "real8_gfx.h"
 #include "real8_cart.h"
+#include "real8_luaheap.h"
 
 #include "../../lib/z8lua/lua.h"
 #include "../../lib/z8lua/lauxlib.h"
@@ -113,6 +114,17 @@ public:
   
   void runFrame();     
   void show_frame();   
+
+  // Spends what is left of a frame that started at frameStartMs on
+  // incremental GC steps, stopping just short of budgetMs. Callers take
+  // out whatever must still fit in the frame (see runFrame).
+  void stepIdleGC(unsigned long frameStartMs, int budgetMs);
+  // Heap size for stat(0): the live estimate from the last mark phase,
+  // so polling it never forces a collection.
+  size_t luaLiveBytes() const;
+#if REAL8_LUA_POOL
+  Real8LuaHeap::Stats luaHeapStats() const { return luaHeap.stats(); }
+#endif
   void setAltFramebuffer(uint8_t *alt, int w, int h) { alt_fb = alt; alt_fb_w = w; alt_fb_h = h; }
   void clearAltFramebuffer() { alt_fb = nullptr; alt_fb_w = PICO_WIDTH; alt_fb_h = PICO_HEIGHT; }
   bool hasAltFramebuffer() const { return alt_fb != nullptr; }
@@ -259,6 +271,11 @@ public:
   // 44100Hz / 60fps = 735 samples * 2 channels = 1470 int16s. Round up for safety.
   int16_t static_audio_buffer[2048];
   bool frame_is_dirty = true;
+  // Frontend frame rate; the audio accumulator hands out exactly
+  // SAMPLE_RATE / LIBRETRO_FPS samples per frame on average.
+  static constexpr int LIBRETRO_FPS = 60;
+  int64_t libretro_audio_accum = 0;
+  void renderLibretroAudio();
 #endif
 
   // --------------------------------------------------------------------------
@@ -423,6 +440,15 @@ public:
   // --------------------------------------------------------------------------
   bool loadGame(const GameData& game);
   void detectCartFPS();
+#if !defined(__GBA__)
+  // Compiled chunk of the current cart. loadGame reuses it when the same
+  // cart is loaded again (run(), reset) and Real8CartCache persists it while
+  // cartBytecodeFresh is set. The key is 0 for carts without a content hash.
+  uint64_t cartCodeKey(const GameData& game) const;
+  std::vector<uint8_t> cartBytecode;
+  uint64_t cartBytecodeKey = 0;
+  bool cartBytecodeFresh = false;
+#endif
 
   // --------------------------------------------------------------------------
   // PERSISTENCE
@@ -460,6 +486,8 @@ public:
   void log(LogChannel ch, const char* fmt, ...);
   bool map_check_flag(int x, int y, int w, int h, int flag);
   bool skip_update_logic = false;
+  // Host frameskip: run _update but not _draw for the next frame only.
+  bool skip_draw_once = false;
 
 #if REAL8_PROFILE_ENABLED
   enum GbaProfileBucket {
@@ -505,6 +533,17 @@ private:
   int lua_ref_update60 = LUA_NOREF;
   int lua_ref_draw = LUA_NOREF;
   int lua_ref_init = LUA_NOREF;
+
+  bool gcIdleCycle = false;
+  bool gcIdleRan = false;      // idle steps ran in the current frame
+  int gcIdleStepMs = 0;
+  int gcIdleDecay = 0;
+  int gcIdleFrames = 0;
+  int gcIdleReserveMs = 0;     // extra margin after frames that overran
+  unsigned long frameBeginMs = 0;
+#if REAL8_LUA_POOL
+  Real8LuaHeap luaHeap; // per-cart arena, released on rebootVM
+#endif
   
   void renderProfileOverlay();
   void initDefaultPalette(); // Still used for VM reboot reset
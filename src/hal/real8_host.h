@@ -3,6 +3,7 @@
 #include <stddef.h>
 #include <vector>
 #include <string>
+#include <cstring>
 
 struct NetworkInfo
 {
@@ -19,6 +20,17 @@ struct MouseState
     uint8_t btn;
 };
 
+// Read-only view of a whole file, see IReal8Host::mapFile(). Hosts that can
+// map files point data into the mapping and keep their state in handle; the
+// default implementation reads into owned instead.
+struct FileMapping
+{
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> owned;
+    void *handle = nullptr;
+};
+
 enum class FramePresentDecision : uint8_t
 {
     Present,
@@ -138,6 +150,30 @@ virtual bool flipScreenRGB565Dirty(const uint16_t* rgb565, int w, int h,
     virtual void deleteFile(const char *path) = 0;
     virtual void getStorageInfo(size_t &used, size_t &total) = 0;
     virtual bool renameGameUI(const char *currentPath) = 0;
+    // Optional: size/mtime for change detection in the shell's library index.
+    virtual bool getFileInfo(const char *path, uint64_t &size, uint64_t &mtime) { (void)path; size = 0; mtime = 0; return false; }
+    // Optional: random access for fixed-size records (library labels).
+    virtual bool readFileRange(const char *path, size_t offset, uint8_t *out, size_t size) {
+        std::vector<uint8_t> data = loadFile(path);
+        if (offset > data.size() || data.size() - offset < size) return false;
+        std::memcpy(out, data.data() + offset, size);
+        return true;
+    }
+    virtual bool writeFileRange(const char *path, size_t offset, const uint8_t *data, size_t size) { (void)path; (void)offset; (void)data; (void)size; return false; }
+    // Optional: zero-copy access to a whole file (mmap/MapViewOfFile). The view
+    // stays valid until unmapFile(); the default falls back to loadFile().
+    virtual bool mapFile(const char *path, FileMapping &map) {
+        map.owned = loadFile(path);
+        map.data = map.owned.data();
+        map.size = map.owned.size();
+        return !map.owned.empty();
+    }
+    virtual void unmapFile(FileMapping &map) {
+        std::vector<uint8_t>().swap(map.owned);
+        map.data = nullptr;
+        map.size = 0;
+        map.handle = nullptr;
+    }
 
     // --- Input (Updated for 8 Players) ---
     // Returns bitmask for a specific player index (0-7)
@@ -160,6 +196,10 @@ virtual bool flipScreenRGB565Dirty(const uint16_t* rgb565, int w, int h,
 
     // --- Audio ---
     virtual void pushAudio(const int16_t *samples, int count) = 0;
+    // Device sample rate for pushAudio(). 0 = use the mixer rate unchanged.
+    virtual int getAudioOutputRate() { return 0; }
+    // Host queue level in 0..1 (0.5 = on target), or < 0 if unknown.
+    virtual float getAudioBufferFill() { return -1.0f; }
 
     // --- Network / OS Actions ---
     virtual NetworkInfo getNetworkInfo() = 0;
@@ -177,3 +217,27 @@ virtual bool flipScreenRGB565Dirty(const uint16_t* rgb565, int w, int h,
     virtual int gpioAnalogRead(int pin) { return 0; }
     virtual void sendSerialStream(const uint8_t *data, int len) {}
 };
+
+// Scoped mapFile()/unmapFile() pair.
+class MappedFile
+{
+public:
+    MappedFile(IReal8Host *host, const char *path) : host(host) { if (host) host->mapFile(path, map); }
+    ~MappedFile() { release(); }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *data() const { return map.data; }
+    size_t size() const { return map.size; }
+    bool empty() const { return map.size == 0; }
+
+    // Drops the view early (e.g. before compiling Lua, to lower peak memory).
+    void release() {
+        if (host) host->unmapFile(map);
+        host = nullptr;
+    }
+
+private:
+    IReal8Host *host;
+    FileMapping map;
+};
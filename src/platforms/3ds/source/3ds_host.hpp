@@ -2849,6 +2849,32 @@ if (gameSubtexTopR) {
         total = 2ULL * 1024 * 1024 * 1024;
     }
 
+    bool getFileInfo(const char *path, uint64_t &size, uint64_t &mtime) override {
+        std::string fullPath = resolveVirtualPath(path);
+        struct stat st;
+        if (stat(fullPath.c_str(), &st) != 0) return false;
+        size = (uint64_t)st.st_size;
+        mtime = (uint64_t)st.st_mtime;
+        return true;
+    }
+
+    bool readFileRange(const char *path, size_t offset, uint8_t *out, size_t size) override {
+        std::ifstream file(resolveVirtualPath(path), std::ios::binary);
+        if (!file.is_open()) return false;
+        file.seekg((std::streamoff)offset, std::ios::beg);
+        return (bool)file.read((char*)out, size);
+    }
+
+    bool writeFileRange(const char *path, size_t offset, const uint8_t *data, size_t size) override {
+        std::string fullPath = resolveVirtualPath(path);
+        std::fstream file(fullPath, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) file.open(fullPath, std::ios::binary | std::ios::out);
+        if (!file.is_open()) return false;
+        file.seekp((std::streamoff)offset, std::ios::beg);
+        file.write((const char*)data, size);
+        return (bool)file;
+    }
+
     bool renameGameUI(const char *currentPath) override {
         std::string fullPath = resolveVirtualPath(currentPath);
         struct stat st;
@@ -5,6 +5,10 @@
 #define CART_BLOB_MAGIC "P8GB"
 #define CART_BLOB_MAGIC_SIZE 4
 #define CART_BLOB_FLAG_NONE 0u
+// Lua part of the payload is a precompiled chunk (see real8_bytecode.h)
+#define CART_BLOB_FLAG_BYTECODE (1u << 3)
+// sizeof(size_t) the chunk is encoded for
+#define CART_BLOB_LUA_SIZE_T 4
 
 struct CartBlobHeader {
     char magic[CART_BLOB_MAGIC_SIZE];
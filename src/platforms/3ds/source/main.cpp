@@ -5,8 +5,10 @@
 #if defined(REAL8_3DS_STANDALONE)
 #include "real8_menu.h"
 #include "real8_cart.h"
+#include "real8_cartcache.h"
 #if defined(REAL8_3DS_EMBED_CART)
 #include "cart_blob.h"
+static_assert(sizeof(size_t) == CART_BLOB_LUA_SIZE_T, "cart packer chunk width must match the device");
 #endif
 #include <cstring>
 #include <fstream>
@@ -195,7 +197,16 @@ int main(int argc, char *argv[])
         }
 
         const size_t luaSize = payloadSize - offset;
-        outData.lua_code.assign(reinterpret_cast<const char*>(payload + offset), luaSize);
+        if (header.flags & CART_BLOB_FLAG_BYTECODE) {
+            // Precompiled by the packer; Real8VM loads it without any source.
+            outData.lua_code.clear();
+            outData.bytecode.assign(payload + offset, payload + offset + luaSize);
+        } else {
+            outData.lua_code.assign(reinterpret_cast<const char*>(payload + offset), luaSize);
+            outData.bytecode.clear();
+        }
+        outData.bytecode_key = 0;
+        outData.content_hash = 0;
         outData.lua_code_ptr = nullptr;
         outData.lua_code_size = 0;
         outData.cart_id.clear();
@@ -282,7 +293,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    if (!Real8CartLoader::LoadFromBuffer(host, fileData, *gameData)) {
+    if (!Real8CartCache::Load(host, fileData.data(), fileData.size(), *gameData)) {
         renderError(vm, "LOAD ERROR", "INVALID CART");
         while (aptMainLoop()) {
             host->pollInput();
@@ -313,6 +324,7 @@ int main(int argc, char *argv[])
         delete host;
         return 1;
     }
+    Real8CartCache::Store(host, vm, *gameData);
 
     vm->gpu.pal_reset();
     host->setInterpolation(vm->interpolation);
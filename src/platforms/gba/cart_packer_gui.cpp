@@ -17,6 +17,7 @@
 #include "cart_blob.h"
 #include "../../hal/real8_host.h"
 #include "../../core/real8_cart.h"
+#include "../../core/real8_bytecode.h"
 
 namespace {
     const int kPadding = 12;
@@ -262,11 +263,20 @@ namespace {
         payload.insert(payload.end(), game.sprite_flags, game.sprite_flags + sizeof(game.sprite_flags));
         payload.insert(payload.end(), game.music, game.music + sizeof(game.music));
         payload.insert(payload.end(), game.sfx, game.sfx + sizeof(game.sfx));
-        payload.insert(payload.end(), game.lua_code.begin(), game.lua_code.end());
+        // Precompile so the device only runs lundump. Line info is stripped:
+        // on the GBA it would cost as much EWRAM as the code itself.
+        std::vector<uint8_t> chunk;
+        std::string compileErr;
+        if (!compile_pico8_bytecode(game.lua_code.data(), game.lua_code.size(), CART_BLOB_LUA_SIZE_T,
+                                    true, chunk, compileErr)) {
+            err = std::string("Failed to compile ") + cartPath + ": " + compileErr;
+            return false;
+        }
+        payload.insert(payload.end(), chunk.begin(), chunk.end());
 
         CartBlobHeader header{};
         memcpy(header.magic, CART_BLOB_MAGIC, CART_BLOB_MAGIC_SIZE);
-        header.flags = CART_BLOB_FLAG_NONE;
+        header.flags = CART_BLOB_FLAG_BYTECODE;
         header.raw_size = (uint32_t)payload.size();
         header.comp_size = (uint32_t)payload.size();
 
@@ -15,6 +15,8 @@
 #include "build/splash_img_bin.h"
 #include "build/splash_pal_bin.h"
 
+static_assert(sizeof(size_t) == CART_BLOB_LUA_SIZE_T, "cart packer chunk width must match the device");
+
 namespace {
     const size_t kCartFixedBytes = 0x4300;
     const int kScreenCenterX = 64;
@@ -124,7 +126,7 @@ namespace {
         memcpy(&header, blob, sizeof(header));
         if (memcmp(header.magic, CART_BLOB_MAGIC, CART_BLOB_MAGIC_SIZE) != 0) return false;
         if (header.raw_size < kCartFixedBytes) return false;
-        if (header.flags != CART_BLOB_FLAG_NONE) return false;
+        if ((header.flags & ~CART_BLOB_FLAG_BYTECODE) != 0) return false;
         if (header.comp_size != header.raw_size) return false;
         if (header.comp_size > (blob_size - sizeof(CartBlobHeader))) return false;
 
@@ -138,8 +140,14 @@ namespace {
         game.sprite_flags = src; src += 0x100;
         game.music = src; src += 0x100;
         game.sfx = src; src += 0x1100;
-        game.lua_code_ptr = reinterpret_cast<const char*>(src);
-        game.lua_code_size = lua_size;
+        if (header.flags & CART_BLOB_FLAG_BYTECODE) {
+            // Precompiled by the packer: lundump reads it straight from ROM.
+            game.bytecode_ptr = src;
+            game.bytecode_size = lua_size;
+        } else {
+            game.lua_code_ptr = reinterpret_cast<const char*>(src);
+            game.lua_code_size = lua_size;
+        }
         game.cart_id = "game.p8.png";
 
         if (rom_view) *rom_view = payload;
@@ -461,6 +469,8 @@ int main(void) {
     game.sfx = nullptr;
     game.lua_code_ptr = nullptr;
     game.lua_code_size = 0;
+    game.bytecode_ptr = nullptr;
+    game.bytecode_size = 0;
     game.cart_id = nullptr;
     host.log("[BOOT] load blob");
     host.renderDebugOverlay();
@@ -473,7 +483,8 @@ int main(void) {
         while (true) host.waitForVBlank();
     }
     vm.setRomView(rom_view, rom_size, true);
-    const bool hasLua = (game.lua_code_ptr && game.lua_code_size > 0);
+    const bool hasLua = (game.lua_code_ptr && game.lua_code_size > 0) ||
+                        (game.bytecode_ptr && game.bytecode_size > 0);
     if (!hasLua) {
         host.log("[BOOT] lua missing");
         showSolid(RGB5(31, 0, 0));
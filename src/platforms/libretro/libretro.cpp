@@ -25,6 +25,23 @@ retro_environment_t environ_cb = nullptr;
 retro_input_poll_t input_poll_cb = nullptr;
 retro_input_state_t input_state_cb = nullptr;
 
+// --- Audio buffer status (frontend-driven frameskip) ---
+// When the frontend reports its audio buffer running low, skip _draw and
+// dupe the previous video frame so emulation catches up without audio gaps.
+static const unsigned kFrameskipThreshold = 33; // occupancy percent
+static const unsigned kMaxFrameskip = 3;        // consecutive skipped frames
+static bool audio_buff_active = false;
+static unsigned audio_buff_occupancy = 0;
+static bool audio_buff_underrun_likely = false;
+static unsigned frameskip_counter = 0;
+static bool can_dupe = false;
+
+static void RETRO_CALLCONV audio_buff_status_cb(bool active, unsigned occupancy, bool underrun_likely) {
+    audio_buff_active = active;
+    audio_buff_occupancy = occupancy;
+    audio_buff_underrun_likely = underrun_likely;
+}
+
 // Define the controller types supported (RetroPad)
 static const struct retro_controller_description controller_def[] = {
    { "RetroPad", RETRO_DEVICE_JOYPAD },
@@ -117,8 +134,8 @@ extern "C" {
         info->geometry.max_width    = 128;
         info->geometry.max_height   = 128;
         info->geometry.aspect_ratio = 1.0f;
-        info->timing.fps = 60.0;
-        info->timing.sample_rate = 22050.0;
+        info->timing.fps = (double)Real8VM::LIBRETRO_FPS;
+        info->timing.sample_rate = (double)AudioEngine::SAMPLE_RATE_NUM / (double)AudioEngine::SAMPLE_RATE_DEN;
     }
 
     void retro_set_environment(retro_environment_t cb) {
@@ -148,10 +165,10 @@ extern "C" {
         // Reset/Load Handling
         if (vm->reset_requested) {
             if (!vm->next_cart_path.empty()) {
-                std::vector<uint8_t> newCartData = host->loadFile(vm->next_cart_path.c_str());
+                MappedFile newCartData(host, vm->next_cart_path.c_str());
                 if (!newCartData.empty()) {
                     GameData newGame;
-                    if (Real8CartLoader::LoadFromBuffer(host, newCartData, newGame)) {
+                    if (Real8CartLoader::LoadFromMemory(host, newCartData.data(), newCartData.size(), newGame)) {
                         gameData = newGame;
                         gameData.cart_id = vm->next_cart_path;
                     }
@@ -181,11 +198,24 @@ extern "C" {
         }
         vm->btn_state = vm->btn_states[0];
 
+        bool skip_video = false;
+        if (audio_buff_active &&
+            (audio_buff_underrun_likely || audio_buff_occupancy < kFrameskipThreshold) &&
+            frameskip_counter < kMaxFrameskip) {
+            skip_video = true;
+            frameskip_counter++;
+        } else {
+            frameskip_counter = 0;
+        }
+        vm->skip_draw_once = skip_video;
+
         vm->runFrame();
-        vm->show_frame(); 
+        if (!skip_video) vm->show_frame(); 
 
         if (video_cb) {
-            video_cb(vm->screen_buffer, 128, 128, 128 * sizeof(uint32_t));
+            // NULL dupes the last frame; otherwise resend the untouched buffer.
+            const void *frame = (skip_video && can_dupe) ? nullptr : vm->screen_buffer;
+            video_cb(frame, 128, 128, 128 * sizeof(uint32_t));
         }
     }
 
@@ -198,12 +228,22 @@ extern "C" {
             return false;
         }
 
+        can_dupe = false;
+        environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe);
+
+        struct retro_audio_buffer_status_callback buf_status_cb;
+        buf_status_cb.callback = audio_buff_status_cb;
+        if (!environ_cb(RETRO_ENVIRONMENT_SET_AUDIO_BUFFER_STATUS_CALLBACK, &buf_status_cb)) {
+            audio_buff_active = false;
+        }
+        frameskip_counter = 0;
+
         if (info->path) {
             host->setContentPath(info->path);
         }
 
-        std::vector<uint8_t> buffer((const uint8_t*)info->data, (const uint8_t*)info->data + info->size);
-        if (Real8CartLoader::LoadFromBuffer(host, buffer, gameData)) {
+        // The frontend keeps info->data alive for the duration of this call.
+        if (Real8CartLoader::LoadFromMemory(host, (const uint8_t*)info->data, info->size, gameData)) {
             gameData.cart_id = "libretro_cart"; 
             vm->loadGame(gameData);
             return true;
@@ -213,6 +253,8 @@ extern "C" {
     }
 
     void retro_unload_game(void) {
+        if (environ_cb) environ_cb(RETRO_ENVIRONMENT_SET_AUDIO_BUFFER_STATUS_CALLBACK, nullptr);
+        audio_buff_active = false;
         if (vm) vm->forceExit();
     }
 
@@ -9,6 +9,12 @@
 #include <ctime>
 #include <fstream>
 #include <algorithm>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // Global callbacks from libretro.cpp
 extern retro_log_printf_t log_cb;
@@ -43,24 +49,22 @@ namespace z8 {
             }
         }
 
-        // --- File I/O (Implemented) ---
-        std::vector<uint8_t> loadFile(const char *path) override {
-            if (!path) return {};
-
-            std::string fullPath;
+        // Handle absolute vs relative paths
+        // If the path implies a root (starts with /), we map it to the game directory for safety
+        std::string resolvePath(const char *path) const {
             std::string filename(path);
-
-            // Handle absolute vs relative paths
-            // If the path implies a root (starts with /), we map it to the game directory for safety
             if (!filename.empty() && (filename[0] == '/' || filename[0] == '\\')) {
                 filename = filename.substr(1);
             }
+            if (!gameDirectory.empty()) return gameDirectory + "/" + filename;
+            return filename;
+        }
 
-            if (!gameDirectory.empty()) {
-                fullPath = gameDirectory + "/" + filename;
-            } else {
-                fullPath = filename;
-            }
+        // --- File I/O (Implemented) ---
+        std::vector<uint8_t> loadFile(const char *path) override {
+            if (!path) return {};
+
+            std::string fullPath = resolvePath(path);
 
             // Standard C++ Binary Read
             std::ifstream file(fullPath, std::ios::binary | std::ios::ate);
@@ -82,6 +86,34 @@ namespace z8 {
             return {};
         }
 
+#if defined(__unix__) || defined(__APPLE__)
+        bool mapFile(const char *path, FileMapping &map) override {
+            if (!path) return false;
+            int fd = open(resolvePath(path).c_str(), O_RDONLY);
+            if (fd < 0) fd = open(path, O_RDONLY); // same fallback as loadFile
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+                close(fd);
+                return false;
+            }
+            void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (view == MAP_FAILED) return false;
+
+            map.data = (const uint8_t *)view;
+            map.size = (size_t)st.st_size;
+            map.handle = view;
+            return true;
+        }
+
+        void unmapFile(FileMapping &map) override {
+            if (map.handle) munmap(map.handle, map.size);
+            IReal8Host::unmapFile(map);
+        }
+#endif
+
         // --- Audio ---
         void pushAudio(const int16_t *samples, int count) override {
             if (audio_batch_cb && count > 0) {
@@ -9,9 +9,14 @@ enum CartBlobFlags : uint32_t {
     CART_BLOB_FLAG_NONE = 0u,
     CART_BLOB_FLAG_STRETCH = 1u << 0,
     CART_BLOB_FLAG_CRTFILTER = 1u << 1,
-    CART_BLOB_FLAG_INTERPOL8 = 1u << 2
+    CART_BLOB_FLAG_INTERPOL8 = 1u << 2,
+    // Lua part of the payload is a precompiled chunk (see real8_bytecode.h)
+    CART_BLOB_FLAG_BYTECODE = 1u << 3
 };
 
+// sizeof(size_t) the chunk is encoded for
+#define CART_BLOB_LUA_SIZE_T 8
+
 struct CartBlobHeader {
     char magic[CART_BLOB_MAGIC_SIZE];
     uint32_t flags;
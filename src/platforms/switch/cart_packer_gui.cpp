@@ -14,6 +14,7 @@
 
 #include "cart_blob.h"
 #include "../../core/real8_cart.h"
+#include "../../core/real8_bytecode.h"
 #include "../../hal/real8_host.h"
 
 namespace {
@@ -676,11 +677,20 @@ namespace {
         payload.insert(payload.end(), game.sprite_flags, game.sprite_flags + sizeof(game.sprite_flags));
         payload.insert(payload.end(), game.music, game.music + sizeof(game.music));
         payload.insert(payload.end(), game.sfx, game.sfx + sizeof(game.sfx));
-        payload.insert(payload.end(), game.lua_code.begin(), game.lua_code.end());
+        // Precompile so the device only runs lundump. Debug info is kept so
+        // runtime errors still report line numbers.
+        std::vector<uint8_t> chunk;
+        std::string compileErr;
+        if (!compile_pico8_bytecode(game.lua_code.data(), game.lua_code.size(), CART_BLOB_LUA_SIZE_T,
+                                    false, chunk, compileErr)) {
+            err = "Failed to compile cart Lua: " + compileErr;
+            return false;
+        }
+        payload.insert(payload.end(), chunk.begin(), chunk.end());
 
         CartBlobHeader header{};
         memcpy(header.magic, CART_BLOB_MAGIC, CART_BLOB_MAGIC_SIZE);
-        header.flags = flags;
+        header.flags = flags | CART_BLOB_FLAG_BYTECODE;
         header.raw_size = (uint32_t)payload.size();
         header.comp_size = (uint32_t)payload.size();
 
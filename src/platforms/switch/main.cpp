@@ -8,9 +8,11 @@
 #if defined(REAL8_SWITCH_STANDALONE)
 #include "../../core/real8_menu.h"
 #include "../../core/real8_cart.h"
+#include "../../core/real8_cartcache.h"
 #if defined(REAL8_SWITCH_EMBED_CART)
 #include "cart_blob.h"
 #include "cart_blob_bin.h"
+static_assert(sizeof(size_t) == CART_BLOB_LUA_SIZE_T, "cart packer chunk width must match the device");
 #endif
 #include <cstring>
 #include <fstream>
@@ -131,7 +133,16 @@ bool loadEmbeddedCartBlob(GameData& outData, uint32_t& outFlags, std::string& er
     }
 
     const size_t luaSize = payloadSize - offset;
-    outData.lua_code.assign(reinterpret_cast<const char*>(payload + offset), luaSize);
+    if (header.flags & CART_BLOB_FLAG_BYTECODE) {
+        // Precompiled by the packer; Real8VM loads it without any source.
+        outData.lua_code.clear();
+        outData.bytecode.assign(payload + offset, payload + offset + luaSize);
+    } else {
+        outData.lua_code.assign(reinterpret_cast<const char*>(payload + offset), luaSize);
+        outData.bytecode.clear();
+    }
+    outData.bytecode_key = 0;
+    outData.content_hash = 0;
     outData.lua_code_ptr = nullptr;
     outData.lua_code_size = 0;
     outData.cart_id.clear();
@@ -248,7 +259,7 @@ int main(int argc, char *argv[])
             return 1;
         }
 
-        if (!Real8CartLoader::LoadFromBuffer(host, fileData, gameData)) {
+        if (!Real8CartCache::Load(host, fileData.data(), fileData.size(), gameData)) {
             renderError(vm, "LOAD ERROR", "INVALID CART");
             waitForExit();
             delete vm;
@@ -276,6 +287,7 @@ int main(int argc, char *argv[])
         SDL_Quit();
         return 1;
     }
+    Real8CartCache::Store(host, vm, gameData);
 
     bool inMenu = false;
     bool inputLatch = false;
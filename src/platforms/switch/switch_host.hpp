@@ -32,6 +32,7 @@ private:
     SDL_Texture *texture;
     SDL_Texture *wallpaperTex;
     SDL_AudioDeviceID audioDevice;
+    int audioRate = 22050;
     SwitchInput input;
     bool curlReady = false;
     bool nifmReady = false;
@@ -390,14 +391,27 @@ public:
     {
         SDL_AudioSpec want, have;
         SDL_zero(want);
-        want.freq = 22050; // Match VM output
+        want.freq = 48000; // Console native rate; the core resamples to it
         want.format = AUDIO_S16SYS;
         want.channels = 1; // Mono output like the VM
         want.samples = 1024;
         want.callback = NULL; // We use SDL_QueueAudio
 
-        audioDevice = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
-        if (audioDevice > 0) SDL_PauseAudioDevice(audioDevice, 0);
+        audioDevice = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+        if (audioDevice > 0) {
+            audioRate = have.freq;
+            SDL_PauseAudioDevice(audioDevice, 0);
+        }
+    }
+
+    int getAudioOutputRate() override { return (audioDevice > 0) ? audioRate : 0; }
+
+    Uint32 audioTargetQueueBytes() const { return (Uint32)(audioRate * 46 / 1000) * sizeof(int16_t); }
+
+    float getAudioBufferFill() override
+    {
+        if (audioDevice == 0) return -1.0f;
+        return (float)SDL_GetQueuedAudioSize(audioDevice) / (float)(2 * audioTargetQueueBytes());
     }
 
     void pushAudio(const int16_t *samples, int count) override
@@ -405,7 +419,7 @@ public:
         if (audioDevice == 0 || samples == nullptr || count == 0) return;
 
         // Keep queue near real-time to avoid pops
-        const Uint32 TARGET_QUEUE_BYTES = 1024 * sizeof(int16_t);
+        const Uint32 TARGET_QUEUE_BYTES = audioTargetQueueBytes();
         const Uint32 MAX_WAIT_CYCLES = 500;
 
         Uint32 queuedBytes = SDL_GetQueuedAudioSize(audioDevice);
@@ -710,6 +724,36 @@ public:
         if (totalSpace >= freeSpace) used = (size_t)(totalSpace - freeSpace);
     }
 
+    // --- Random-Access File IO ---
+    bool getFileInfo(const char *path, uint64_t &size, uint64_t &mtime) override {
+        std::error_code ec;
+        fs::path fullPath = resolveVirtualPath(path);
+        uintmax_t bytes = fs::file_size(fullPath, ec);
+        if (ec) return false;
+        auto stamp = fs::last_write_time(fullPath, ec);
+        if (ec) return false;
+        size = (uint64_t)bytes;
+        mtime = (uint64_t)stamp.time_since_epoch().count();
+        return true;
+    }
+
+    bool readFileRange(const char *path, size_t offset, uint8_t *out, size_t size) override {
+        std::ifstream file(resolveVirtualPath(path), std::ios::binary);
+        if (!file.is_open()) return false;
+        file.seekg((std::streamoff)offset, std::ios::beg);
+        return (bool)file.read((char *)out, size);
+    }
+
+    bool writeFileRange(const char *path, size_t offset, const uint8_t *data, size_t size) override {
+        std::string fullPath = resolveVirtualPath(path);
+        std::fstream file(fullPath, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) file.open(fullPath, std::ios::binary | std::ios::out);
+        if (!file.is_open()) return false;
+        file.seekp((std::streamoff)offset, std::ios::beg);
+        file.write((const char *)data, size);
+        return (bool)file;
+    }
+
     // --- Switch Native Keyboard for Rename ---
     bool renameGameUI(const char *currentPath) override
     {
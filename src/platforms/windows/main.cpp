@@ -41,6 +41,8 @@ enum MenuID
     ID_EXT_EXPORT_MAP,
     ID_EXT_EXPORT_VARS,
     ID_EXT_EXPORT_MUSIC,
+    ID_EXT_EXPORT_AUDIO,
+    ID_EXT_EXPORT_AUDIO_STEMS,
     ID_EXT_EXPORT_GAMECARD,
     ID_EXT_REALTIME_MODS,
     ID_SET_SHOW_CONSOLE
@@ -188,6 +190,7 @@ enum {
     ID_GC_COVER,
     ID_GC_BROWSE,
     ID_GC_COMP_PXA,
+    ID_GC_COMP_PXA_FAST,
     ID_GC_COMP_LEGACY,
     ID_GC_RESET,
     ID_GC_EXPORT
@@ -253,9 +256,11 @@ static LRESULT CALLBACK GamecardDialogProc(HWND hWnd, UINT message, WPARAM wPara
         CreateWindow("STATIC", "Compression:", WS_CHILD | WS_VISIBLE,
                      pad, y, labelW, editH, hWnd, NULL, NULL, NULL);
         HWND hCompPxa = CreateWindow("BUTTON", "PXA", WS_CHILD | WS_VISIBLE | BS_AUTORADIOBUTTON | WS_GROUP,
-                                     pad + labelW, y, 80, editH, hWnd, (HMENU)(UINT_PTR)ID_GC_COMP_PXA, NULL, NULL);
+                                     pad + labelW, y, 60, editH, hWnd, (HMENU)(UINT_PTR)ID_GC_COMP_PXA, NULL, NULL);
+        HWND hCompPxaFast = CreateWindow("BUTTON", "PXA Fast", WS_CHILD | WS_VISIBLE | BS_AUTORADIOBUTTON,
+                                         pad + labelW + 65, y, 85, editH, hWnd, (HMENU)(UINT_PTR)ID_GC_COMP_PXA_FAST, NULL, NULL);
         HWND hCompLegacy = CreateWindow("BUTTON", "Legacy", WS_CHILD | WS_VISIBLE | BS_AUTORADIOBUTTON,
-                                        pad + labelW + 90, y, 90, editH, hWnd, (HMENU)(UINT_PTR)ID_GC_COMP_LEGACY, NULL, NULL);
+                                        pad + labelW + 155, y, 75, editH, hWnd, (HMENU)(UINT_PTR)ID_GC_COMP_LEGACY, NULL, NULL);
         SendMessage(hCompPxa, BM_SETCHECK, BST_CHECKED, 0);
 
         y += editH + 14;
@@ -276,6 +281,7 @@ static LRESULT CALLBACK GamecardDialogProc(HWND hWnd, UINT message, WPARAM wPara
             SendMessage(hCoverEdit, WM_SETFONT, (WPARAM)state->font, TRUE);
             SendMessage(hBrowseBtn, WM_SETFONT, (WPARAM)state->font, TRUE);
             SendMessage(hCompPxa, WM_SETFONT, (WPARAM)state->font, TRUE);
+            SendMessage(hCompPxaFast, WM_SETFONT, (WPARAM)state->font, TRUE);
             SendMessage(hCompLegacy, WM_SETFONT, (WPARAM)state->font, TRUE);
             SendMessage(hResetBtn, WM_SETFONT, (WPARAM)state->font, TRUE);
             SendMessage(hExportBtn, WM_SETFONT, (WPARAM)state->font, TRUE);
@@ -308,6 +314,7 @@ static LRESULT CALLBACK GamecardDialogProc(HWND hWnd, UINT message, WPARAM wPara
             std::string author = GetDlgItemTextString(hWnd, ID_GC_AUTHOR);
             std::string cover = GetDlgItemTextString(hWnd, ID_GC_COVER);
             bool useLegacy = (IsDlgButtonChecked(hWnd, ID_GC_COMP_LEGACY) == BST_CHECKED);
+            bool useFast = (IsDlgButtonChecked(hWnd, ID_GC_COMP_PXA_FAST) == BST_CHECKED);
 
             if (title.empty()) {
                 MessageBoxA(hWnd, "Please enter a Game Title.", "Missing Title", MB_OK | MB_ICONWARNING);
@@ -331,7 +338,7 @@ static LRESULT CALLBACK GamecardDialogProc(HWND hWnd, UINT message, WPARAM wPara
 
             Real8Tools::GamecardCompression compression = useLegacy
                 ? Real8Tools::GamecardCompression::Legacy
-                : Real8Tools::GamecardCompression::Pxa;
+                : (useFast ? Real8Tools::GamecardCompression::PxaFast : Real8Tools::GamecardCompression::Pxa);
             bool ok = Real8Tools::ExportGamecard(state->vm, state->host, outputPath, title, author, cover, templatePng, compression);
             if (!ok) {
                 MessageBoxA(hWnd, "Export failed. Check logs.txt for details.", "Export Failed", MB_OK | MB_ICONERROR);
@@ -442,6 +449,8 @@ void UpdateMenuState(HMENU hMenu, Real8VM *vm, SDL_Window *window, WindowsHost*
     EnableMenuItem(hMenu, ID_EXT_EXPORT_GFX, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
     EnableMenuItem(hMenu, ID_EXT_EXPORT_MAP, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
     EnableMenuItem(hMenu, ID_EXT_EXPORT_MUSIC, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
+    EnableMenuItem(hMenu, ID_EXT_EXPORT_AUDIO, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
+    EnableMenuItem(hMenu, ID_EXT_EXPORT_AUDIO_STEMS, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
     EnableMenuItem(hMenu, ID_EXT_EXPORT_GAMECARD, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
     EnableMenuItem(hMenu, ID_EXT_REALTIME_MODS, MF_BYCOMMAND | (gameRunning ? MF_ENABLED : MF_GRAYED));
 }
@@ -590,6 +599,8 @@ int main(int argc, char *argv[])
     AppendMenu(hExtraMenu, MF_STRING, ID_EXT_EXPORT_GFX, "Export GFX");
     AppendMenu(hExtraMenu, MF_STRING, ID_EXT_EXPORT_MAP, "Export MAP");
     AppendMenu(hExtraMenu, MF_STRING, ID_EXT_EXPORT_MUSIC, "Export Music Tracks");
+    AppendMenu(hExtraMenu, MF_STRING, ID_EXT_EXPORT_AUDIO, "Export Audio (WAV)");
+    AppendMenu(hExtraMenu, MF_STRING, ID_EXT_EXPORT_AUDIO_STEMS, "Export Audio Stems (WAV)");
     AppendMenu(hExtraMenu, MF_STRING, ID_EXT_EXPORT_GAMECARD, "Export Gamecard");
     AppendMenu(hExtraMenu, MF_SEPARATOR, 0, NULL);
     AppendMenu(hExtraMenu, MF_STRING, ID_EXT_REALTIME_MODS, "RealTime Modding");
@@ -857,6 +868,18 @@ int main(int argc, char *argv[])
                                     if(!f.empty()) Real8Tools::ExportMusic(vm, host, f); // FIXED
                                 } 
                                 break;
+
+                            case ID_EXT_EXPORT_AUDIO:
+                            case ID_EXT_EXPORT_AUDIO_STEMS:
+                                if(!vm->currentGameId.empty()) {
+                                    std::string f=BrowseFolder(hwnd);
+                                    if(!f.empty()) {
+                                        Real8Tools::AudioExportMode mode = (menuID == ID_EXT_EXPORT_AUDIO_STEMS)
+                                            ? Real8Tools::AudioExportMode::Stems : Real8Tools::AudioExportMode::Mix;
+                                        Real8Tools::ExportAudio(vm, host, f, mode);
+                                    }
+                                }
+                                break;
                             case ID_EXT_EXPORT_GAMECARD:
                                 if (!vm->currentGameId.empty()) {
                                     bool wasPaused = vm->debug.paused;
@@ -70,6 +70,7 @@ private:
     SDL_Texture *texture;
     SDL_Texture *wallpaperTex;
     SDL_AudioDeviceID audioDevice;
+    int audioRate = 22050;
     WindowsInput input;
     SDL_Window* sdlWindow; 
     SDL_Window* bottomWindow = nullptr;
@@ -1965,21 +1966,34 @@ public:
         SDL_AudioSpec want, have;
         SDL_zero(want);
         
-        want.freq = 22050;       // PICO-8 standard
+        want.freq = 48000;       // Preferred; the device may pick its own
         want.format = AUDIO_S16SYS;
         want.channels = 1;       // Mono
         want.samples = 1024;     // Internal buffer size
         want.callback = NULL;    // We use SDL_QueueAudio
 
-        // Change 'SDL_AUDIO_ALLOW_FORMAT_CHANGE' to 0.
-        // This forces SDL to emulate 22050Hz S16 even if the hardware is 48000Hz Float.
-        audioDevice = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+        // Format and channel count stay fixed (S16 mono), but accept the
+        // device's native frequency: the core resamples to it, so SDL doesn't
+        // have to run its own converter.
+        audioDevice = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
 
         if (audioDevice != 0) {
+            audioRate = have.freq;
             SDL_PauseAudioDevice(audioDevice, 0); // Unpause immediately
         }
     }
 
+    int getAudioOutputRate() override { return (audioDevice != 0) ? audioRate : 0; }
+
+    // ~46ms latency target, independent of the device rate.
+    Uint32 audioTargetQueueBytes() const { return (Uint32)(audioRate * 46 / 1000) * sizeof(int16_t); }
+
+    float getAudioBufferFill() override
+    {
+        if (audioDevice == 0) return -1.0f;
+        return (float)SDL_GetQueuedAudioSize(audioDevice) / (float)(2 * audioTargetQueueBytes());
+    }
+
     // In windows_host.hpp
 
     void pushAudio(const int16_t *samples, int count) override
@@ -1990,7 +2004,7 @@ public:
         // Don't drop samples. If the queue is full, we WAIT.
         // This syncs the game loop to the audio hardware, preventing pops/clicks.
         
-        const Uint32 TARGET_QUEUE_BYTES = 1024 * sizeof(int16_t); // ~46ms latency target
+        const Uint32 TARGET_QUEUE_BYTES = audioTargetQueueBytes();
         const Uint32 MAX_WAIT_CYCLES = 500; // Timeout safety
 
         Uint32 queuedBytes = SDL_GetQueuedAudioSize(audioDevice);
@@ -2152,6 +2166,67 @@ public:
 
     void getStorageInfo(size_t &used, size_t &total) override { used = 0; total = 1024 * 1024 * 1024; }
 
+    bool getFileInfo(const char *path, uint64_t &size, uint64_t &mtime) override
+    {
+        std::error_code ec;
+        fs::path fullPath = resolveVirtualPath(path);
+        uintmax_t bytes = fs::file_size(fullPath, ec);
+        if (ec) return false;
+        auto stamp = fs::last_write_time(fullPath, ec);
+        if (ec) return false;
+        size = (uint64_t)bytes;
+        mtime = (uint64_t)stamp.time_since_epoch().count();
+        return true;
+    }
+
+    bool readFileRange(const char *path, size_t offset, uint8_t *out, size_t size) override
+    {
+        std::ifstream file(resolveVirtualPath(path), std::ios::binary);
+        if (!file.is_open()) return false;
+        file.seekg((std::streamoff)offset, std::ios::beg);
+        return (bool)file.read((char *)out, size);
+    }
+
+    bool writeFileRange(const char *path, size_t offset, const uint8_t *data, size_t size) override
+    {
+        std::string fullPath = resolveVirtualPath(path);
+        std::fstream file(fullPath, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) file.open(fullPath, std::ios::binary | std::ios::out);
+        if (!file.is_open()) return false;
+        file.seekp((std::streamoff)offset, std::ios::beg);
+        file.write((const char *)data, size);
+        return (bool)file;
+    }
+
+    bool mapFile(const char *path, FileMapping &map) override
+    {
+        fs::path fullPath = resolveVirtualPath(path);
+        HANDLE file = CreateFileW(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER len;
+        if (!GetFileSizeEx(file, &len) || len.QuadPart <= 0 || (uint64_t)len.QuadPart > SIZE_MAX) {
+            CloseHandle(file);
+            return false;
+        }
+        // The view keeps the mapping (and the file) alive on its own.
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) return false;
+        map.data = (const uint8_t *)view;
+        map.size = (size_t)len.QuadPart;
+        map.handle = view;
+        return true;
+    }
+
+    void unmapFile(FileMapping &map) override
+    {
+        if (map.handle) UnmapViewOfFile(map.handle);
+        IReal8Host::unmapFile(map);
+    }
+
     bool renameGameUI(const char *currentPath) override
     {
         std::string fullPath = resolveVirtualPath(currentPath);